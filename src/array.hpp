@@ -2,52 +2,52 @@
 #define _ARRAY_
 #include <vector>
 #include <algorithm>
+#include <cctype>
 #include <cmath>
+#include <iterator>
 #include <random>
 #include <istream>
+#include <numeric>
+#include <stack>
+#include <type_traits>
+#include "partition.hpp"
+#include "patterns.hpp"
+#include "permutation.hpp"
+#include "balanced_subarray.hpp"
+#include "beautiful_arrangement.hpp"
+#include "heavy_hitters.hpp"
+#include "jump_index.hpp"
+#include "stock.hpp"
+#include "rotated_index.hpp"
+#include "sliding_window.hpp"
+#include "sorted_set.hpp"
+#include "sort.hpp"
 
-namespace algorithms { 
+namespace algorithms {
 namespace array {
 
 /**
- * Partition the elements of an array 
- * such that all elements satisfying predicate p
- * are at the left of all other elements.
- * Runtime complexity : O(n).
+ * All the algorithms in this module come in two flavours:
+ * a range overload, taking a pair of iterators [first,last)
+ * (pointers into external buffers, std::array, std::vector, ...),
+ * which works in place and does not copy the input,
+ * and a std::vector overload, which is a thin wrapper around it.
  */
-template <typename T, typename P>
-void partition(::std::vector<T> *vp, P p) {
-  auto &v = *vp;
-  int i1 = 0, i2 = v.size()-1;
-  while (i1 <= i2) {
-    if (p(v[i1])) ++i1;
-    else ::std::swap(v[i1],v[i2--]);
-  }
-}
 
 /**
- * 3-way-partition the elements of an array 
- * such that all elements are partitioned in 3 areas:
- * less than pivot - equal to pivot - greater than pivot.
+ * Partition the elements of an integer array
+ * such that even elements are at the left of odd elements.
  * Runtime complexity : O(n).
  */
-template <typename T>
-void partition(::std::vector<T> *vp, const T &pivot) {
-  auto &v = *vp;
-  int i1 = 0, i2 = 0, i3 = v.size()-1;
-  while (i2 <= i3) {
-    if (v[i2] == pivot) ++i2;
-    else if (v[i2] < pivot) ::std::swap(v[i1++],v[i2++]);
-    else ::std::swap(v[i2], v[i3--]);
-  }
-}
+void even_odd(::std::vector<int> *vp);
 
 /**
- * Partition the elements of an integer array 
- * such that even elements are at the left of odd elements.
- * Runtime complexity : O(n).
+ * Range overload of even_odd, based on the branchless partition.
  */
-void even_odd(::std::vector<int> *vp);
+template <typename RandomIt>
+void even_odd(RandomIt first, RandomIt last) {
+  ::algorithms::array::partition_branchless(first, last, [](const auto &x){return (x%2)==0;});
+}
 
 /**
  * Increment an arbitrary-precision unsigned integer,
@@ -56,24 +56,115 @@ void even_odd(::std::vector<int> *vp);
  */
 void increment(::std::vector<int> *vp);
 
+/**
+ * Range overload of increment.
+ * The range cannot grow, so the carry out of the MSB (0 or 1)
+ * is returned, and it is up to the caller to prepend it.
+ */
+template <typename BidirIt>
+int increment(BidirIt first, BidirIt last) {
+  int carry = 1;
+  while (carry != 0 && first != last) {
+    --last;
+    *last += carry;
+    carry = *last/10;
+    *last %= 10;
+  }
+  return carry;
+}
+
 /**
  * Multiply two arbitrary-precision integers
  * represented as vectors a and b of integers in the range [0-9]
- * of sizes n and m respectively, with the MSB at index 0. 
+ * of sizes n and m respectively, with the MSB at index 0.
  * The MSB might be negative, to represent negative numbers.
  * Runtime complexity : O(mn)
  */
 ::std::vector<int> multiply(const ::std::vector<int> &a, const ::std::vector<int> &b);
 
 /**
- * Given an array of n integers a, 
- * a[i] denotes the maximum you can advance from index i. 
+ * Range overload of multiply.
+ * The result is written starting at r_first, which must have
+ * room for max(1,n+m) digits. Return the number of digits written.
+ */
+template <typename RandomIt1, typename RandomIt2, typename RandomIt3>
+int multiply(RandomIt1 a_first, RandomIt1 a_last,
+             RandomIt2 b_first, RandomIt2 b_last, RandomIt3 r_first) {
+  if (a_first == a_last || b_first == b_last) {
+    *r_first = 0;
+    return 1;
+  }
+  int n = a_last-a_first, m = b_last-b_first;
+  int sign = (*a_first * *b_first < 0)?-1:1;
+
+  ::std::fill(r_first, r_first+n+m, 0);
+  for (int i=n-1; i>=0; --i) {
+    int carry = 0;
+    for (int j=m-1; j>=0; --j) {
+      r_first[i+j+1] += abs(a_first[i])*abs(b_first[j]) + carry;
+      carry = r_first[i+j+1]/10;
+      r_first[i+j+1] %= 10;
+    }
+    if (carry) r_first[i] += carry;
+  }
+
+  auto msd = ::std::find_if(r_first, r_first+n+m, [](int d){ return d;});
+  // this check is necessary for handling the case a = {0} or b = {0} correctly
+  if (msd == r_first+n+m) {
+    *r_first = 0;
+    return 1;
+  }
+  int len = r_first+n+m-msd;
+  ::std::copy(msd, r_first+n+m, r_first);
+  *r_first *= sign;
+  return len;
+}
+
+/**
+ * Given an array of n integers a,
+ * a[i] denotes the maximum you can advance from index i.
  * Return the minimum number of steps to advance to the last index
  * starting from the beginning of the array, or -1 if the last index is unreachable.
+ * See jump_index for queries between any two indices.
  * Runtime complexity : O(n)
  */
 int can_reach_end(const ::std::vector<int> &a);
 
+/**
+ * Range overload of can_reach_end.
+ * Runtime complexity : O(n), O(1) additional space
+ */
+template <typename RandomIt>
+int can_reach_end(RandomIt first, RandomIt last) {
+  /**
+   * Let s[i] denote the minimum number of steps
+   * necessary to reach index i.
+   * Note that s is non-decreasing (i<j implies s[i]<=s[j]).
+   * Indeed, if i<j but s[i]>s[j], that would mean
+   * that we could reach j using less steps than the ones necessary to reach i,
+   * but this is a contradiction, since if we are able
+   * to reach j with s[j] steps, then also i is reachable
+   * with at most s[j] steps.
+   * Hence the indices reachable with exactly k steps form
+   * a contiguous block (b_{k-1},b_k], and we only need
+   * to keep track of the boundary b of the current block
+   * and of the farthest index reachable from it.
+   */
+  using diff = typename ::std::iterator_traits<RandomIt>::difference_type;
+  diff n = last-first, b = 0, farthest = 0;
+  int steps = 0;
+  for (diff i=0; i<n-1; ++i) {
+    farthest = ::std::max(farthest, i+static_cast<diff>(first[i]));
+    if (i == b) {
+      if (farthest <= i) return -1;
+      ++steps;
+      b = farthest;
+      if (b >= n-1) break;
+    }
+  }
+  return steps;
+}
+
 /**
  * Given a sorted array of n integers a,
  * remove all duplicate elements and
@@ -82,36 +173,126 @@ int can_reach_end(const ::std::vector<int> &a);
  */
 int delete_dupes(::std::vector<int> *vp);
 
+/**
+ * Range overload of delete_dupes.
+ * Return the new end of the range.
+ * See sorted_set.hpp for the parallel version
+ * and for the other operations on sorted sets.
+ */
+template <typename ForwardIt>
+ForwardIt delete_dupes(ForwardIt first, ForwardIt last) {
+  return ::algorithms::array::dedup(first, last);
+}
+
 /**
  * Given an array v of n elements of type double,
  * denoting the daily stock price,
- * return the maximum profit that could be made 
+ * return the maximum profit that could be made
  * by buying and then selling one share of that stock.
  * Runtime complexity : O(n)
  */
 double buy_and_sell_stock_once(const ::std::vector<double> &v);
 
+/**
+ * Range overload of buy_and_sell_stock_once.
+ */
+template <typename InputIt>
+double buy_and_sell_stock_once(InputIt first, InputIt last) {
+  if (first == last) return 0.0;
+  double max_profit = 0.0;
+  double cur_min = *first;
+  for (++first; first != last; ++first) {
+    max_profit = ::std::max(max_profit, *first-cur_min);
+    cur_min = ::std::min(cur_min, static_cast<double>(*first));
+  }
+  return max_profit;
+}
+
 /**
  * Given an array v of n elements of type double,
  * denoting the daily stock price,
- * return the maximum profit that could be made 
+ * return the maximum profit that could be made
  * by buying and then selling one share of that stock at most twice.
  * Runtime complexity : O(n)
  */
 double buy_and_sell_stock_twice(const ::std::vector<double> &v);
 
 /**
- * Given two integers n and k, construct a list 
- * which contains n different positive integers 
+ * Range overload of buy_and_sell_stock_twice.
+ * Runtime complexity : O(n), O(1) additional space
+ */
+template <typename InputIt>
+double buy_and_sell_stock_twice(InputIt first, InputIt last) {
+  if (first == last) return 0.0;
+
+  /**
+   * Keep the best balance after each of the four
+   * actions buy1, sell1, buy2, sell2
+   * on the prefix seen so far. Buying and selling
+   * on the same day yields no profit, so the updates
+   * can be done in place.
+   */
+  double buy1 = -*first, sell1 = 0.0, buy2 = -*first, sell2 = 0.0;
+  for (++first; first != last; ++first) {
+    double p = *first;
+    buy1 = ::std::max(buy1, -p);
+    sell1 = ::std::max(sell1, buy1+p);
+    buy2 = ::std::max(buy2, sell1-p);
+    sell2 = ::std::max(sell2, buy2+p);
+  }
+  return sell2;
+}
+
+/**
+ * Given two integers n and k, construct a list
+ * which contains n different positive integers
  * ranging from 1 to n and obeys the following requirement:
- * Suppose this list is [a1, a2, a3, ... , an], then the list 
- * [|a1 - a2|, |a2 - a3|, |a3 - a4|, ... , |an-1 - an|] 
+ * Suppose this list is [a1, a2, a3, ... , an], then the list
+ * [|a1 - a2|, |a2 - a3|, |a3 - a4|, ... , |an-1 - an|]
  * has exactly k distinct integers.
  * n and k are in the range 1 <= k < n <= 1e4.
+ * See beautiful_arrangement for a lazy version, with 64-bit n.
  * Runtime complexity : O(n)
  */
 ::std::vector<int> beautiful_arrangement_ii(int n, int k);
 
+/**
+ * Range overload of beautiful_arrangement_ii.
+ * The n elements are written starting at out.
+ */
+template <typename RandomIt>
+void beautiful_arrangement_ii(int n, int k, RandomIt out) {
+  /**
+   * The idea here is that we can always construct
+   * a permutation of 1..n such that, taking the
+   * absolute difference of consecutive elements,
+   * we have a number h of 1s ranging from 1 to n-1,
+   * while the remaining n-h differences
+   * are the numbers 2,3,...,n-h occurring
+   * exacly once.
+   * We can achieve this by ordering the elements
+   * from 1 to h in the first part of the array,
+   * and then alternating the residual max and
+   * the residual min in the second part of the array.
+   * Fo example, for n = 5, we get:
+   *
+   * h = 4 : v = [1 - 2 - 3 - 4 - 5]
+   *                1   1   1   1
+   * h = 3 : v = [1 - 2 - 3 - 5 - 4]
+   *                1   1   2   1
+   * h = 2 : v = [1 - 2 - 5 - 3 - 4]
+   *                1   3   2   1
+   * h = 1 : v = [1 - 5 - 2 - 4 - 3]
+   *                4   3   2   1
+   *
+   * The problem is solved by constructing the
+   * sequence corresponding to h = n-k.
+   */
+  for (int i=0; i<n-k; ++i) out[i] = i+1;
+  for (int i=n-k, cur=n; i<n; i+=2, --cur) out[i]=cur;
+  for (int i=n-k+1, cur=n-k+1; i<n; i+=2, ++cur) out[i]=cur;
+}
+
 /**
  * Given an integer n, return all the primes between 1 and n.
  * Runtime complexity : O(n/2 + n/3 + n/7 + n/11 + ...) = O(nloglogn) - sieve of Erathostenes
@@ -122,19 +303,23 @@ double buy_and_sell_stock_twice(const ::std::vector<double> &v);
  * Given an array v of n elements and a permutation p, apply p to a.
  * p is specified as an array of n unique integers from 0 to n-1,
  * where p[i] represents the new index of element v[i].
+ * See permutation.hpp for the range overloads, out of place
+ * and parallel application, inversion and composition.
  * Runtime complexity : O(n)
  */
 void apply_permutation(::std::vector<int> *pp, ::std::vector<int> *vp);
 
 /**
  * Given an array v of n distinct element representing a
- * permutation of the numbers 0..n-1, 
+ * permutation of the numbers 0..n-1,
  * modify it in-place so that it contains the next permutation
- * in lexicographic order. If there is no next permutation,
- * leave the array unchanged.
+ * in lexicographic order, and return true. If there is no next permutation,
+ * leave the array unchanged, and return false.
+ * See permutation.hpp for the range overload, and for
+ * the enumeration of permutations in batches and in shards.
  * Runtime complexity : O(n)
  */
-void next_permutation(::std::vector<int> *vp);
+bool next_permutation(::std::vector<int> *vp);
 
 /**
  * Given an array v of n disinct elements and a
@@ -145,13 +330,28 @@ void next_permutation(::std::vector<int> *vp);
 ::std::vector<int> random_sampling(::std::vector<int> *vp, int k);
 
 /**
- * Given a size k in input, maintain a random subset of 
+ * Range overload of random_sampling.
+ * The range is reordered in place so that the sample
+ * ends up in [first,first+k).
+ * Runtime complexity : O(k)
+ */
+template <typename RandomIt>
+void random_sampling(RandomIt first, RandomIt last, int k) {
+  using diff = typename ::std::iterator_traits<RandomIt>::difference_type;
+  ::std::default_random_engine en((::std::random_device())());
+  for (diff i=0; i<k; ++i) {
+    ::std::iter_swap(first+i,first+::std::uniform_int_distribution<diff>{i,last-first-1}(en));
+  }
+}
+
+/**
+ * Given a size k in input, maintain a random subset of
  * size k from an input stream of integers.
  * Runtime complexity : O(1) per input read
  */
 class online_random_sampler {
 public:
-  online_random_sampler(int k, ::std::istream *in) : 
+  online_random_sampler(int k, ::std::istream *in) :
     k(k), n(0), in(in), en(::std::random_device{}()) {
     set.reserve(k);
   };
@@ -176,7 +376,21 @@ private:
 ::std::vector<int> generate_permutation(int n);
 
 /**
- * Given an array of n integers v, 
+ * Range overload of generate_permutation:
+ * fill [first,last) with a random permutation of [0...n-1],
+ * where n is the length of the range.
+ */
+template <typename RandomIt>
+void generate_permutation(RandomIt first, RandomIt last) {
+  using diff = typename ::std::iterator_traits<RandomIt>::difference_type;
+  diff n = last-first;
+  ::std::iota(first,last,0);
+  ::std::default_random_engine en(::std::random_device{}());
+  for (diff i=0; i<n-1; ++i) ::std::iter_swap(first+i,first+::std::uniform_int_distribution<diff>{i,n-1}(en));
+}
+
+/**
+ * Given an array of n integers v,
  * return whether an increasing subsequence
  * of length 3 exists or not in the array.
  * Runtime complexity : O(n)
@@ -184,20 +398,97 @@ private:
 bool increasing_triplet(const ::std::vector<int> &v);
 
 /**
- * Given an array of n integers v, 
+ * Range overload of increasing_triplet.
+ */
+template <typename RandomIt>
+bool increasing_triplet(RandomIt first, RandomIt last) {
+  if (first == last) return false;
+
+  /**
+   * idea: maintain two quantities for each
+   * subarray v[i..n-1], while decreasing i to 0:
+   *  1 - the current maximum element index "m"
+   *  2 - a pair "p" of indices such that
+   *      2.a   - i <= p.first < p.second <= n-1
+   *      2.b   - v[p.first] < v[p.second]
+   *      2.c   - among pairs of indices satisfying 2.a and 2.b,
+   *              p is one with maximum p.first.
+   */
+  using diff = typename ::std::iterator_traits<RandomIt>::difference_type;
+  auto v = first;
+  diff m = last-first-1;
+  ::std::pair<diff,diff> p{-1,-1};
+  for (diff i=m-1; i>=0; --i) {
+    if (p.first<0 || v[i]>v[p.first]) {
+      if (v[i]<v[m]) p={i,m};
+      else m=i;
+    }
+    else if (v[i]<v[p.first]) return true;
+  }
+  return false;
+}
+
+/**
+ * Given an array of n integers v,
  * a 132 pattern is a subsequence v[i], v[j], v[k]
- * such that i < j < k and a[i] < a[k] < a[j]. 
+ * such that i < j < k and a[i] < a[k] < a[j].
  * Design an algorithm that takes a list of n numbers
  * as input and checks whether there is a 132 pattern in the list.
  * Runtime complexity : O(n)
  */
 bool find_123_pattern(const ::std::vector<int> &v);
 
+/**
+ * Range overload of find_123_pattern.
+ */
+template <typename RandomIt>
+bool find_123_pattern(RandomIt first, RandomIt last) {
+  if (first == last) return false;
+
+  /**
+   * Idea for the algorithm:
+   * 1 - for each subarray v[i..n-1], keep a pair of indices (j_i, k_i) such that:
+   *   1.a - i <= j_i < k_i < n
+   *   1.b - v[ji] > v[ki]
+   *   1.c - among the set of all couples (l,m) satisfying properties 1.a and 1.b,
+   *         (j_i, k_i) is one with maximal v[k_i]
+   *
+   * 2 - maintain a stack s of indices such that:
+   *   2.a - s contains all indices l such that i <= l < n and v[l] > v[k_i]
+   *   2.b - the indices l in s are ordered in ascending order of l and v[l] from the top to the
+   *         bottom of the stack
+   *
+   * When examining a new element v[i-1], if v[i-1] > v[k_i], then we can always
+   * find an index l in range i..n-1 such that couple (i-1,l) can be chosen as (j_{i-1}, k_{i-1});
+   * it's sufficient to choose as k_{i-1} the biggest index l among {k_i} U s such that v[i-1] > v[l].
+   * So start by putting (j_{i-1}, k_{i-1}) = (i,k_i), keep popping from s and set k_{i-1} to
+   * the popped index as long as v[i-1] > v[popped index].
+   * After the pops, all indices in s will satisfy property 2.b.
+   * To make propery 2.a true for the new stack, add i to the top of the stack.
+   */
+  using diff = typename ::std::iterator_traits<RandomIt>::difference_type;
+  auto v = first;
+  ::std::stack<diff> s;
+  ::std::pair<diff,diff> p{-1,-1};
+  for (diff i=last-first-1; i>=0; --i) {
+    if (p.second<0 || v[i]>v[p.second]) {
+      p = {i,p.second};
+      while (!s.empty() && v[i] > v[s.top()]) {
+	p.second = s.top();
+	s.pop();
+      }
+      s.push(i);
+    }
+    else if (v[i]<v[p.second]) return true;
+  }
+  return false;
+}
+
 /**
  * Given a sorted array of n integers v
- * that has been rotated an unknown number of times, 
- * write code to find an element in the array. 
- * You may assume that the array was originally 
+ * that has been rotated an unknown number of times,
+ * write code to find an element in the array.
+ * You may assume that the array was originally
  * sorted in increasing order.
  * Runtime complexity : O(n) (if repeated elements)
  *                      O(logn) (if unique elements)
@@ -205,13 +496,94 @@ bool find_123_pattern(const ::std::vector<int> &v);
 int search_rotated(const ::std::vector<int> &v, int t);
 
 /**
- * Given an array filled with letters and numbers, find 
- * the longest subarray with an equal number of letters 
+ * Range overload of search_rotated.
+ * Return an iterator to the element found, or last if t is not there.
+ */
+template <typename RandomIt, typename T>
+RandomIt search_rotated(RandomIt first, RandomIt last, const T &t) {
+
+  /**
+   * We do a pseudo binary search,
+   * comparing target t with the middle element a[m]
+   * and with the extreme elements a[s] and a[e].
+   * We make sure the array has at least length 3
+   * so that s < m < e.
+   * As long as a[s] != a[m] or a[e] != a[m],
+   * we can always recurse on one of the two halves,
+   * otherwise we need to do a linear scan.
+   * Here are all the possible cases:
+   *
+   *  * t = a[m] --> return true
+   *  * a[s] = a[m] = a[e] --> full search;
+   *  * a[s] < a[m]
+   *    * t >= a[s] && t < a[m] --> e=m-1
+   *    * t > a[m] || t < a[s] --> s=m+1
+   *  * a[s] > a[m]
+   *    * t >= a[s] || t < a[m] --> e=m-1
+   *    * t > a[m] && t < a[s] --> s=m+1
+   *  * a[e] > a[m]
+   *    * t > a[m] && t <= a[e] --> s=m+1
+   *    * t < a[m] || t > a[e] --> e=m-1
+   *  * a[e] < a[m]
+   *    * t > a[m] || t <= a[e] --> s=m+1
+   *    * t < a[m] && t > a[e] --> e=m-1
+   */
+  using diff = typename ::std::iterator_traits<RandomIt>::difference_type;
+  auto v = first;
+  diff s=0, e=last-first-1;
+  while(e-s+1>=3) {
+    diff m=s+(e-s)/2;
+    if (t==v[m]) return first+m;
+
+    if (v[s]==v[m] && v[m]==v[e]) break; // linear search needed
+    else if (v[s]<v[m]) {
+      if (t>=v[s] && t<v[m]) e=m-1;
+      else s=m+1;
+    }
+    else if(v[s]>v[m]) {
+      if (t>=v[s] || t<v[m]) e=m-1;
+      else s=m+1;
+    }
+    else if (v[e]>v[m]) {
+      if (t>v[m] && t<=v[e]) s=m+1;
+      else e=m-1;
+    }
+    else if(v[e]<v[m]) {
+      if (t>v[m] || t<=v[e]) s=m+1;
+      else e=m-1;
+    }
+  }
+
+  // if we ended up here, we need a linear search
+  for (diff i=s; i<=e; ++i) {
+    if (v[i]==t) return first+i;
+  }
+  return last;
+}
+
+/**
+ * Given an array filled with letters and numbers, find
+ * the longest subarray with an equal number of letters
  * and numbers.
  * Runtime complexity : O(n)
  */
 ::std::pair<int,int> find_longest_subarray(const ::std::vector<char> &v);
 
+/**
+ * Range overload of find_longest_subarray.
+ * Return the (inclusive) index bounds of the subarray,
+ * or {0,-1} if there is none.
+ * See balanced_subarray_index for range queries and other classifiers.
+ */
+template <typename RandomIt>
+::std::pair<typename ::std::iterator_traits<RandomIt>::difference_type,
+            typename ::std::iterator_traits<RandomIt>::difference_type>
+find_longest_subarray(RandomIt first, RandomIt last) {
+  using diff = typename ::std::iterator_traits<RandomIt>::difference_type;
+  auto r = balanced_subarray_index<>(first, last).longest();
+  return {static_cast<diff>(r.first), static_cast<diff>(r.second)};
+}
+
 /**
  * A circus is designing a tower routine consisting of people
  * standing atop one another's shoulders.
@@ -224,21 +596,65 @@ int search_rotated(const ::std::vector<int> &v, int t);
  */
 ::std::vector<::std::pair<int,int>> circus_tower(::std::vector<::std::pair<int,int>> *vp);
 
+/**
+ * Range overload of circus_tower.
+ * The range is sorted in place.
+ */
+template <typename RandomIt>
+::std::vector<typename ::std::iterator_traits<RandomIt>::value_type>
+circus_tower(RandomIt first, RandomIt last) {
+  using value_type = typename ::std::iterator_traits<RandomIt>::value_type;
+  if (first == last) return {};
+
+  /**
+   * Idea: sort v by height first, and resolve ties by weight.
+   * The sequence we are looking for must be a subsequence of
+   * the so-sorted sequence, and more precisely the maximum increasing subsequence.
+   */
+  ::algorithms::sort::pdqsort(first, last, [](const value_type &p1, const value_type &p2) {
+      if (p1.first == p2.first && p1.second < p2.second) return true;
+      if (p1.first < p2.first) return true;
+      return false;
+  });
+
+  struct item {
+    int prev;
+    int length;
+  };
+
+  auto v = first;
+  int n = last-first;
+  ::std::vector<item> m(n,{-1,1});
+  int maxidx = 0;
+  for (int i=0; i<n; ++i) {
+    for (int j=0; j<i; ++j) {
+      if (v[j].second < v[i].second && m[i].length < m[j].length+1) {
+	m[i]={j,m[j].length+1};
+      }
+    }
+    maxidx=m[i].length>m[maxidx].length?i:maxidx;
+  }
+
+ ::std::vector<value_type> result(m[maxidx].length);
+ for (int i=result.size()-1, j=maxidx; i>=0; --i, j=m[j].prev) result[i]=v[j];
+ return result;
+}
+
 /**
  * In a row of trees, the i-th tree produces fruit with type tree[i].
- * You start at any tree of your choice, 
+ * You start at any tree of your choice,
  * then repeatedly perform the following steps:
  *
- * - Add one piece of fruit from this tree to your baskets.  
+ * - Add one piece of fruit from this tree to your baskets.
  *   If you cannot, stop.
  *
- * - Move to the next tree to the right of the current tree.  
+ * - Move to the next tree to the right of the current tree.
  *   If there is no tree to the right, stop.
  *
- * Note that you do not have any choice after the initial choice 
- * of starting tree: you must perform step 1, then step 2, 
+ * Note that you do not have any choice after the initial choice
+ * of starting tree: you must perform step 1, then step 2,
  * then back to step 1, then step 2, and so on until you stop.
- * You have two baskets, and each basket can carry any quantity of fruit, 
+ * You have two baskets, and each basket can carry any quantity of fruit,
  * but you want each basket to only carry one type of fruit each.
  * What is the total amount of fruit you can collect with this procedure?a
  * Runtime complexity : O(n)
@@ -246,20 +662,116 @@ int search_rotated(const ::std::vector<int> &v, int t);
 int total_fruit(const ::std::vector<int> &v);
 
 /**
- * A majority element is an element 
- * that makes up more than half of the items in an array. 
- * Given a positive integers array, find the majority element. 
- * If there is no majority element, return -1. 
+ * Range overload of total_fruit: the longest subarray
+ * with at most 2 distinct elements (see sliding_window.hpp).
+ */
+template <typename ForwardIt>
+int total_fruit(ForwardIt first, ForwardIt last) {
+  return ::algorithms::array::longest_at_most_k_distinct(first, last, 2);
+}
+
+/**
+ * A majority element is an element
+ * that makes up more than half of the items in an array.
+ * Given a positive integers array, find the majority element.
+ * If there is no majority element, return -1.
  * Runtime complexity : O(n)
  */
 int majority_element(const ::std::vector<int> &v);
 
 /**
- * Given an integer array of size n, 
- * find all elements that appear more than n/3 times.
+ * Range overload of majority_element.
+ */
+template <typename ForwardIt>
+int majority_element(ForwardIt first, ForwardIt last) {
+
+  /*
+   * Let x be the majority element,
+   * and let i and j two indices in v such that v[i]!=v[j].
+   * Then x is also the majority element of vector w,
+   * obtained from v by removing indices i and j.
+   * The algorithm is keeps annihilating different
+   * elements as we see them, keeping the candidate
+   * to be the majority element.
+   * The stack below only ever holds copies of the
+   * same element, so it is enough to keep the element
+   * and the height of the stack (Boyer-Moore vote).
+   * It then verifies that it is indeed the majority element.
+   * Example: [1,2,5,9,5,9,5,5,5]
+   *
+   *  | | | | | | | | |5|
+   *  | | | | | | | |5|5|
+   *  |1|_|5|_|5|_|5|5|5|
+   *
+   * Result = 5
+   *
+   */
+
+  int cand = -1, count = 0;
+  for (auto it=first; it!=last; ++it) {
+    if (count==0) {cand=*it; count=1;}
+    else if (cand==*it) ++count;
+    else --count;
+  }
+
+  if (count==0) return -1;
+  count = ::std::count(first,last,cand);
+  return count>::std::distance(first,last)/2?cand:-1;
+}
+
+/**
+ * Given an integer array of size n,
+ * find all elements that appear more than n/3 times,
+ * in increasing order.
  * Runtime complexity : O(n)
  */
 ::std::vector<int> majority_element_ii(const ::std::vector<int> &v);
+
+/**
+ * Range overload of majority_element_ii, for forward iterators:
+ * random access ranges go through the parallel heavy_hitters,
+ * other ones through a single Misra-Gries pass and a counting pass.
+ */
+template <typename ForwardIt>
+::std::vector<typename ::std::iterator_traits<ForwardIt>::value_type>
+majority_element_ii(ForwardIt first, ForwardIt last) {
+  using value_type = typename ::std::iterator_traits<ForwardIt>::value_type;
+
+  /*
+   * There can be at most 2 elements
+   * occurring more than n/3 times.
+   * Removing 3 distinct elements from v
+   * won't change these majority elements, if there
+   * are some. So the approach is similar to
+   * majority_element.
+   * Example: [1,2,1,2,2,1,5,2,1]
+   *
+   *   |   |   |   |   |  2|1 2|   |  2|1 2|
+   *   |   |   |1  |1 2|1 2|1 2|1 2|1 2|1 2|
+   *   |1,_|1,2|1,2|1,2|1,2|1,2|1,2|1,2|1,2|
+   *
+   * Result = {1,2}
+   *
+   * This is the Misra-Gries summary with k=3 (see heavy_hitters).
+   */
+  if constexpr (::std::is_base_of_v<::std::random_access_iterator_tag,
+                typename ::std::iterator_traits<ForwardIt>::iterator_category>) {
+    return ::algorithms::array::heavy_hitters(first, last, 3);
+  } else {
+    misra_gries<value_type> summary(3);
+    summary.add(first, last);
+    ::std::vector<value_type> cand;
+    for (auto &e : summary.entries()) cand.push_back(e.first);
+    ::std::vector<long long> counts(cand.size(), 0);
+    count_candidates(first, last, cand.data(), cand.size(), counts.data());
+    ::std::vector<value_type> result;
+    for (::std::size_t j=0; j<cand.size(); ++j) {
+      if (counts[j]*3 > summary.size()) result.push_back(cand[j]);
+    }
+    ::std::sort(result.begin(), result.end());
+    return result;
+  }
+}
 } // array
 } // algorithms
 
@@ -0,0 +1,289 @@
+#ifndef _BALANCED_SUBARRAY_
+#define _BALANCED_SUBARRAY_
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <utility>
+
+namespace algorithms {
+namespace array {
+
+/**
+ * Default classifier for balanced subarrays:
+ * +1 for decimal digits, -1 for everything else.
+ * The test is a single unsigned comparison, with no
+ * locale lookup, so that the classification loop is branchless.
+ */
+struct digit_or_letter {
+  int operator()(char c) const {
+    return static_cast<unsigned char>(c-'0') < 10 ? 1 : -1;
+  }
+};
+
+/**
+ * Prefix-sum index for balanced subarray queries over [first,last):
+ * every element is classified as +1 or -1 by classify,
+ * and a subarray [i,j] is balanced if its classes sum to 0,
+ * that is if the prefix sums P[i] and P[j+1] are equal.
+ * Prefix sums are in [-n,n], so tables indexed by value
+ * are flat arrays offset by n instead of hash maps.
+ * Bounds are returned as (first,last) inclusive indices,
+ * or (0,-1) if there is no balanced subarray.
+ */
+template <typename Classify = digit_or_letter>
+class balanced_subarray_index {
+public:
+  template <typename RandomIt>
+  balanced_subarray_index(RandomIt first, RandomIt last, Classify classify = Classify()) :
+    _n(last-first), _sum(_n+1) {
+    // classify first, in a loop without dependencies, then prefix-sum
+    ::std::vector<int> c(_n);
+    for (long long i=0; i<_n; ++i) c[i] = classify(first[i]);
+    _sum[0] = 0;
+    ::std::partial_sum(c.begin(), c.end(), _sum.begin()+1);
+  }
+
+  /**
+   * Longest balanced subarray of the whole array.
+   * Runtime complexity : O(n)
+   */
+  ::std::pair<long long,long long> longest() const {
+    return longest(0, _n-1);
+  }
+
+  /**
+   * Precompute the tables answering longest(l,r) in sublinear time:
+   * prefix indices are split in blocks of size b ~ sqrt(n), the answer
+   * is stored for every range of whole blocks, and the positions
+   * of every prefix sum are kept in increasing order.
+   * Runtime complexity : O(nsqrt(n)) time, O(n) space
+   */
+  void build_tables() {
+    long long m = _n+1; // prefix indices
+    _block = ::std::max(1LL, static_cast<long long>(::std::sqrt(static_cast<double>(m))));
+    _blocks = (m+_block-1)/_block;
+
+    // positions sorted by prefix sum (counting sort), and the rank of every position
+    _start.assign(2*_n+2, 0);
+    for (long long p=0; p<m; ++p) ++_start[_sum[p]+_n+1];
+    ::std::partial_sum(_start.begin(), _start.end(), _start.begin());
+    _occ.resize(m);
+    _rank.resize(m);
+    ::std::vector<long long> next(_start.begin(), _start.end()-1);
+    for (long long p=0; p<m; ++p) {
+      _rank[p] = next[_sum[p]+_n]++;
+      _occ[_rank[p]] = p;
+    }
+
+    // _table[i*_blocks+j] is the answer over the prefix indices of blocks i..j
+    _table.assign(_blocks*_blocks, {0,-1});
+    ::std::vector<long long> first_seen(2*_n+1, -1), touched;
+    for (long long i=0; i<_blocks; ++i) {
+      for (auto v : touched) first_seen[v] = -1;
+      touched.clear();
+      ::std::pair<long long,long long> best{0,-1};
+      for (long long p=i*_block; p<m; ++p) {
+        long long v = _sum[p]+_n;
+        if (first_seen[v] < 0) {
+          first_seen[v] = p;
+          touched.push_back(v);
+        } else if (p-first_seen[v] > best.second-best.first+1) {
+          best = {first_seen[v], p-1};
+        }
+        if ((p+1)%_block == 0 || p == m-1) _table[i*_blocks+p/_block] = best;
+      }
+    }
+  }
+
+  /**
+   * Longest balanced subarray within [l,r], clamped to the array
+   * (none if the clamped range is empty).
+   * Once build_tables has been called, the answer over the whole
+   * blocks of the range is looked up, and the positions of the partial
+   * blocks at its ends are matched with the last (first) position
+   * of their prefix sum within the range, by binary search.
+   * Otherwise, the range is scanned.
+   * Runtime complexity : O(sqrt(n)logn) with the tables, O(r-l) otherwise
+   */
+  ::std::pair<long long,long long> longest(long long l, long long r) const {
+    l = ::std::max(l, 0LL);
+    r = ::std::min(r, _n-1);
+    if (r < l) return {0,-1};
+    if (!_table.empty() && (r+1)/_block-l/_block >= 2) return lookup(l, r+1);
+    ::std::vector<long long> first_seen(2*(r-l+1)+1, -1);
+    long long offset = (r-l+1)-_sum[l];
+    ::std::pair<long long,long long> best{0,-1};
+    for (long long j=l; j<=r+1; ++j) {
+      long long &f = first_seen[_sum[j]+offset];
+      if (f < 0) f = j;
+      else if (j-f > best.second-best.first+1) best = {f, j-1};
+    }
+    return best;
+  }
+
+  /**
+   * Longest balanced subarray within each of the ranges [l,r]
+   * in [first,last), written starting at out.
+   * Queries are answered offline with Mo's algorithm with rollback:
+   * prefix indices are split in blocks of size b ~ sqrt(n),
+   * and the queries starting in the same block are sorted by end.
+   * For each block, the part of the queries right of the block
+   * only grows, keeping the first and last position of each prefix sum,
+   * while the part within the block (less than b positions)
+   * is scanned for each query and then rolled back.
+   * Every answer is the one of longest(l,r): among the longest
+   * balanced subarrays, the one starting first.
+   * Runtime complexity : O((n+q)sqrt(n))
+   */
+  template <typename InputIt, typename OutputIt>
+  void longest_many(InputIt first, InputIt last, OutputIt out) const {
+    ::std::vector<::std::pair<long long,long long>> queries(first, last);
+    ::std::size_t q = queries.size();
+    ::std::vector<::std::pair<long long,long long>> result(q, {0,-1});
+    long long m = _n+1; // prefix indices
+    long long b = ::std::max(1LL, static_cast<long long>(::std::sqrt(static_cast<double>(m))));
+
+    // prefix index range of query k is [queries[k].first, queries[k].second+1]
+    ::std::vector<::std::size_t> order;
+    for (::std::size_t k=0; k<q; ++k) {
+      auto &[l, r] = queries[k];
+      l = ::std::max(l, 0LL);
+      r = ::std::min(r, _n-1);
+      if (r < l) continue;
+      if (r+1-l < b) result[k] = longest(l, r);
+      else order.push_back(k);
+    }
+    ::std::sort(order.begin(), order.end(), [&](::std::size_t x, ::std::size_t y) {
+      long long bx = queries[x].first/b, by = queries[y].first/b;
+      return bx != by ? bx < by : queries[x].second < queries[y].second;
+    });
+
+    ::std::vector<long long> first_r(2*_n+1, -1), last_r(2*_n+1, -1), last_l(2*_n+1, -1);
+    ::std::vector<long long> touched;
+    ::std::pair<long long,long long> best_r{0,-1};
+    long long block = -1, end = 0, boundary = 0;
+    for (auto k : order) {
+      auto [l, r] = queries[k];
+      if (l/b != block) {
+        // new block: reset the right part
+        for (auto v : touched) first_r[v] = last_r[v] = -1;
+        touched.clear();
+        block = l/b;
+        boundary = (block+1)*b;
+        end = boundary;
+        best_r = {0,-1};
+      }
+      for (; end <= r+1; ++end) {
+        long long v = _sum[end]+_n;
+        if (first_r[v] < 0) {
+          first_r[v] = end;
+          touched.push_back(v);
+        }
+        last_r[v] = end;
+        if (end-first_r[v] > best_r.second-best_r.first+1) best_r = {first_r[v], end-1};
+      }
+
+      // as long and starting earlier also wins, as in longest(l,r)
+      auto best = best_r;
+      long long left_end = ::std::min(boundary, r+2);
+      for (long long i=left_end-1; i>=l; --i) {
+        long long v = _sum[i]+_n;
+        if (last_l[v] < 0) last_l[v] = i;
+        long long j = last_r[v] >= 0 ? last_r[v] : last_l[v];
+        long long len = j-i, best_len = best.second-best.first+1;
+        if (len > best_len || (len == best_len && len > 0)) best = {i, j-1};
+      }
+      for (long long i=left_end-1; i>=l; --i) last_l[_sum[i]+_n] = -1;
+      result[k] = best;
+    }
+    ::std::copy(result.begin(), result.end(), out);
+  }
+
+  long long size() const {
+    return _n;
+  }
+
+private:
+  // answer over the prefix indices [lo,hi], spanning at least 3 blocks
+  ::std::pair<long long,long long> lookup(long long lo, long long hi) const {
+    long long bl = lo/_block+1, br = hi/_block-1;
+    auto best = _table[bl*_blocks+br];
+    // longer, or as long and starting earlier, as the scan does
+    auto consider = [&](long long p, long long q) {
+      long long len = q-p, best_len = best.second-best.first+1;
+      if (len > best_len || (len == best_len && len > 0 && p < best.first)) best = {p, q-1};
+    };
+    for (long long p=lo; p<bl*_block; ++p) {
+      long long v = _sum[p]+_n;
+      auto it = ::std::upper_bound(_occ.begin()+_rank[p], _occ.begin()+_start[v+1], hi);
+      consider(p, *(it-1));
+    }
+    for (long long q=(br+1)*_block; q<=hi; ++q) {
+      long long v = _sum[q]+_n;
+      consider(*::std::lower_bound(_occ.begin()+_start[v], _occ.begin()+_rank[q]+1, lo), q);
+    }
+    return best;
+  }
+
+  long long _n;
+  ::std::vector<long long> _sum;
+  // tables of build_tables, empty until it is called
+  long long _block = 1;
+  long long _blocks = 0;
+  ::std::vector<long long> _start;
+  ::std::vector<long long> _occ;
+  ::std::vector<long long> _rank;
+  ::std::vector<::std::pair<long long,long long>> _table;
+};
+
+/**
+ * Longest balanced subarray of a stream of elements,
+ * read one at a time.
+ * The first occurrence of each prefix sum is kept in two flat arrays,
+ * for the non-negative and the negative sums, which grow
+ * with the range of the prefix sums seen so far.
+ * Runtime complexity : O(1) amortized per element
+ */
+template <typename Classify = digit_or_letter>
+class balanced_subarray_stream {
+public:
+  explicit balanced_subarray_stream(Classify classify = Classify()) :
+    _classify(classify), _n(0), _sum(0), _pos{0}, _best{0,-1} {};
+
+  void push(char c) {
+    ++_n;
+    _sum += _classify(c);
+    auto &table = _sum >= 0 ? _pos : _neg;
+    ::std::size_t idx = _sum >= 0 ? _sum : -_sum-1;
+    if (idx == table.size()) table.push_back(_n);
+    else if (_n-table[idx] > _best.second-_best.first+1) _best = {table[idx], _n-1};
+  }
+
+  /**
+   * Longest balanced subarray of the elements read so far.
+   */
+  ::std::pair<long long,long long> longest() const {
+    return _best;
+  }
+
+  long long size() const {
+    return _n;
+  }
+
+private:
+  Classify _classify;
+  long long _n;
+  long long _sum;
+  // _pos[s] (_neg[s]) is the first prefix index with sum s (-s-1)
+  ::std::vector<long long> _pos;
+  ::std::vector<long long> _neg;
+  ::std::pair<long long,long long> _best;
+};
+
+} // array
+} // algorithms
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef _BEAUTIFUL_ARRANGEMENT_
+#define _BEAUTIFUL_ARRANGEMENT_
+#include <vector>
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include "parallel.hpp"
+#include "partition.hpp"
+
+namespace algorithms {
+namespace array {
+
+/**
+ * Lazy beautiful arrangement of 1..n with k distinct differences
+ * (see beautiful_arrangement_ii), for 1 <= k < n < 2^64:
+ * with h = n-k, the arrangement is 1..h followed by the alternating
+ * residual maximum and minimum n, h+1, n-1, h+2, ..., so that
+ * its i-th element is a closed formula of i, and nothing is stored.
+ */
+class beautiful_arrangement {
+public:
+  beautiful_arrangement(unsigned long long n, unsigned long long k) : _n(n), _h(n-k) {};
+
+  /**
+   * Return the i-th element (from 0).
+   * Runtime complexity : O(1)
+   */
+  unsigned long long operator[](unsigned long long i) const {
+    if (i < _h) return i+1;
+    unsigned long long d = i-_h;
+    return d%2 ? _h+1+d/2 : _n-d/2;
+  }
+
+  unsigned long long size() const {
+    return _n;
+  }
+
+  /**
+   * Write the elements [b,e) starting at out.
+   * Runtime complexity : O(e-b)
+   */
+  template <typename OutputIt>
+  OutputIt write(unsigned long long b, unsigned long long e, OutputIt out) const {
+    for (unsigned long long i=b; i<e; ++i) *out++ = (*this)[i];
+    return out;
+  }
+
+  /**
+   * Write the n elements to the random access range starting at out
+   * (e.g. a memory mapped file) on t threads
+   * (0 means one per hardware thread), each writing a contiguous chunk.
+   * Runtime complexity : O(n/t)
+   */
+  template <typename RandomIt>
+  void parallel_write(RandomIt out, unsigned t = 0) const {
+    parallel::for_chunks(_n, t, kParallelMinChunk, [&](::std::size_t, ::std::size_t b, ::std::size_t e) {
+      write(b, e, out+b);
+    });
+  }
+
+  /**
+   * Write the n elements as decimal text to os, each followed by sep,
+   * formatting them on t threads (0 means one per hardware thread).
+   * The arrangement is processed in rounds of t blocks of kTextBlock
+   * elements: the blocks are formatted in parallel into per thread
+   * buffers, which are then written in order, so that the memory used
+   * does not depend on n.
+   * Runtime complexity : O(n/t) formatting, O(n) writing
+   */
+  void write_text(::std::ostream &os, char sep = '\n', unsigned t = 0) const {
+    static const ::std::size_t kTextBlock = 1<<16;
+    // at most 20 digits per element, and the separator
+    static const ::std::size_t kMaxChars = 21;
+    unsigned c = parallel::threads(t);
+    // chunks have at least kTextBlock elements, hence less than 2*kTextBlock
+    ::std::vector<::std::string> buffers(c, ::std::string(2*kTextBlock*kMaxChars, '\0'));
+    ::std::vector<::std::size_t> sizes(c);
+    for (unsigned long long base=0; base<_n; ) {
+      ::std::size_t len = ::std::min<unsigned long long>(_n-base, c*kTextBlock);
+      ::std::size_t chunks = parallel::chunks(len, c, kTextBlock);
+      parallel::for_chunks(len, c, kTextBlock, [&](::std::size_t i, ::std::size_t b, ::std::size_t e) {
+        char *p = &buffers[i][0], *end = p+buffers[i].size();
+        for (::std::size_t j=b; j<e; ++j) {
+          p = ::std::to_chars(p, end, (*this)[base+j]).ptr;
+          *p++ = sep;
+        }
+        sizes[i] = p-&buffers[i][0];
+      });
+      for (::std::size_t i=0; i<chunks; ++i) os.write(buffers[i].data(), sizes[i]);
+      base += len;
+    }
+  }
+
+private:
+  unsigned long long _n;
+  unsigned long long _h;
+};
+
+} // array
+} // algorithms
+
+#endif
@@ -16,53 +16,76 @@ namespace bit {
  * It can answer to queries like:
  *  - how many keys smaller than (or equal to) a given value are there in the set?
  *  - how many keys in the range [low,high] are there in the set?
- * Keys can be repeated.
+ * Keys can be repeated, and each occurrence can carry a weight
+ * of type C (1 by default), in which case the queries
+ * return the total weight of the keys instead of their number.
  */
-template<typename T>
+template<typename T, typename C = int>
 class bit {
 public:    
     bit(const ::std::vector<T> &ref);
-    int countSmaller(const T &val);
-    int countSmallerOrEqual(const T &val);
-    void update(const T &val);
+    C countSmaller(const T &val);
+    C countSmallerOrEqual(const T &val);
+    void update(const T &val, C weight = 1);
+    int select(C k);
 
 protected:
-    int _count(int idx);
-    void _update(int idx);
+    C _count(int idx);
+    void _update(int idx, C weight);
 
 private:
     const ::std::vector<T> &_ref;
-    ::std::vector<int> _bit;
+    ::std::vector<C> _bit;
 };
 
-template <typename T>
-bit<T>::bit(const ::std::vector<T> &ref) :
+template <typename T, typename C>
+bit<T,C>::bit(const ::std::vector<T> &ref) :
   _ref(ref), 
   _bit(ref.size()+1) 
 {};
 
 /*********** bit *************/
-template<typename T>
-int bit<T>::countSmaller(const T &val) {
+template<typename T, typename C>
+C bit<T,C>::countSmaller(const T &val) {
   int idx=lower_bound(_ref.begin(),_ref.end(),val)-_ref.begin();
   return _count(idx);
 }
 
-template<typename T>
-int bit<T>::countSmallerOrEqual(const T &val) {
+template<typename T, typename C>
+C bit<T,C>::countSmallerOrEqual(const T &val) {
   int idx=upper_bound(_ref.begin(),_ref.end(),val)-_ref.begin();
   return _count(idx);
 }
 
-template<typename T>
-void bit<T>::update(const T &val) {
+template<typename T, typename C>
+void bit<T,C>::update(const T &val, C weight) {
   int idx=upper_bound(_ref.begin(),_ref.end(),val)-_ref.begin();
-  _update(idx);
+  _update(idx, weight);
 }
 
-template<typename T>
-int bit<T>::_count(int idx) {
-  int c=0;
+/**
+ * Return the index in ref of the k-th smallest key in the set
+ * (from 0, counting repetitions), or ref.size() if there are
+ * not more than k keys, descending the tree from its root
+ * one power of two at a time. Weights must be non-negative.
+ * Runtime complexity : O(logn)
+ */
+template<typename T, typename C>
+int bit<T,C>::select(C k) {
+  int pos=0, n=_bit.size()-1, step=1;
+  while (2*step<=n) step*=2;
+  for (; step>0; step/=2) {
+    if (pos+step<=n && _bit[pos+step]<=k) {
+      pos+=step;
+      k-=_bit[pos];
+    }
+  }
+  return pos;
+}
+
+template<typename T, typename C>
+C bit<T,C>::_count(int idx) {
+  C c=0;
   while (idx>0) {
     c+=_bit[idx];
     idx-=idx&-idx;
@@ -70,10 +93,10 @@ int bit<T>::_count(int idx) {
   return c;                
 }
 
-template<typename T>
-void bit<T>::_update(int idx) {
+template<typename T, typename C>
+void bit<T,C>::_update(int idx, C weight) {
   while (idx<_bit.size()) {
-    _bit[idx]+=1;
+    _bit[idx]+=weight;
     idx+=idx&-idx;
   }            
 }    
@@ -107,8 +107,41 @@ double power(double x, int m) {
 }
 
 /************** is_palyndrome ****************/
+namespace {
+const unsigned long long kPowers10[20] = {
+  1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+  100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+  10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+  100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+// number of decimal digits of x, from its bit length b:
+// 10^t <= 2^(b-1) <= x < 2^b <= 10^(t+1), with t = floor(b*log10(2))
+int digits_helper(unsigned long long x) {
+  int b = 1;
+#if defined(__GNUC__)
+  if (x) b = 64-__builtin_clzll(x);
+#else
+  for (unsigned long long y=x>>1; y; y>>=1) ++b;
+#endif
+  // log10(2) ~ 1233/4096
+  int t = b*1233 >> 12;
+  return t + (x >= kPowers10[t]);
+}
+} // anonymous
+
+bool is_palyndrome(unsigned long long x) {
+  int d = digits_helper(x);
+  unsigned long long hi = x/kPowers10[(d+1)/2], lo = x%kPowers10[d/2], rev = 0;
+  for (int i=0; i<d/2; ++i) {
+    rev = rev*10 + hi%10;
+    hi /= 10;
+  }
+  return rev == lo;
+}
+
 bool is_palyndrome(unsigned x) {
-  return x == reverse_digits(x);
+  return is_palyndrome(static_cast<unsigned long long>(x));
 }
 
 
@@ -1,9 +1,13 @@
 #ifndef _BITWISE_
 #define _BITWISE_
+#include <cstddef>
+#include "parallel.hpp"
 
 namespace algorithms { 
 namespace bitwise {
 
+const ::std::size_t kPalyndromeMinChunk = 1<<14;
+
 /**
  * Count the bits set to 1 in the n-bit number x.
  * Runtime complexity : O(k), where k is the number 
@@ -62,10 +66,26 @@ double power(double x, int m);
 
 /**
  * Check if a decimal integer is a palyndrome.
+ * The number of digits d is found from the bit length of x,
+ * and only the upper d/2 digits are reversed and compared
+ * with the lower ones, so that nothing overflows.
  * Runtime complexity : O(n).
  */
 bool is_palyndrome(unsigned x);
+bool is_palyndrome(unsigned long long x);
 
+/**
+ * Check if each of the decimal integers in [first,last) is a palyndrome,
+ * writing the results starting at out, on t threads
+ * (0 means one per hardware thread), each checking a chunk of them.
+ * Runtime complexity : O(n*m/t), for n integers of m bits
+ */
+template <typename RandomIt, typename RandomOutputIt>
+void is_palyndrome_many(RandomIt first, RandomIt last, RandomOutputIt out, unsigned t = 0) {
+  parallel::for_chunks(last-first, t, kPalyndromeMinChunk, [&](::std::size_t, ::std::size_t b, ::std::size_t e) {
+    for (::std::size_t i=b; i<e; ++i) out[i] = is_palyndrome(static_cast<unsigned long long>(first[i]));
+  });
+}
 
 } // bitwise
 } // algorithms
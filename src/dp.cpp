@@ -1,5 +1,6 @@
 #include "dp.hpp"
 #include <algorithm>
+#include <limits>
 
 namespace algorithms {
 namespace dp {
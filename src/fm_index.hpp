@@ -0,0 +1,300 @@
+#ifndef _FM_INDEX_
+#define _FM_INDEX_
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "suffix_array.hpp"
+
+namespace algorithms {
+namespace string {
+
+inline int popcount_helper(::std::uint64_t x) {
+#if defined(__GNUC__)
+  return __builtin_popcountll(x);
+#else
+  x = x - ((x >> 1) & 0x5555555555555555ULL);
+  x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+  x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+  return (x * 0x0101010101010101ULL) >> 56;
+#endif
+}
+
+/**
+ * Bitvector of n bits answering rank and select queries:
+ * the number of ones before every block of 512 bits
+ * is stored (1/8 of the size of the bits), and the ones inside
+ * a block are counted word by word.
+ * Bits are set before calling build, which computes the counts.
+ * Runtime complexity : O(n) construction, O(1) rank, O(logn) select
+ */
+class rank_bitvector {
+public:
+  explicit rank_bitvector(::std::size_t n = 0) : _n(n), _words(n/64+1, 0) {}
+
+  void set(::std::size_t i) {
+    _words[i/64] |= ::std::uint64_t(1) << i%64;
+  }
+
+  void build() {
+    _blocks.assign(_words.size()/kBlockWords+1, 0);
+    ::std::size_t ones = 0;
+    for (::std::size_t w=0; w<=_words.size(); ++w) {
+      if (w%kBlockWords == 0) _blocks[w/kBlockWords] = ones;
+      if (w < _words.size()) ones += popcount_helper(_words[w]);
+    }
+    _ones = ones;
+  }
+
+  bool operator[](::std::size_t i) const {
+    return _words[i/64] >> i%64 & 1;
+  }
+
+  /**
+   * Return the number of ones in [0,i), for i <= n.
+   */
+  ::std::size_t rank1(::std::size_t i) const {
+    ::std::size_t w = i/64, r = _blocks[w/kBlockWords];
+    for (::std::size_t k=w/kBlockWords*kBlockWords; k<w; ++k) r += popcount_helper(_words[k]);
+    if (i%64) r += popcount_helper(_words[w] & ((::std::uint64_t(1) << i%64)-1));
+    return r;
+  }
+
+  ::std::size_t rank0(::std::size_t i) const {
+    return i-rank1(i);
+  }
+
+  /**
+   * Return the position of the k-th one (from 0), for k < rank1(n).
+   */
+  ::std::size_t select1(::std::size_t k) const {
+    ::std::size_t b = ::std::upper_bound(_blocks.begin(), _blocks.end(), k)-_blocks.begin()-1;
+    ::std::size_t w = b*kBlockWords;
+    k -= _blocks[b];
+    for (int c; k >= static_cast<::std::size_t>(c = popcount_helper(_words[w])); ++w) k -= c;
+    ::std::uint64_t x = _words[w];
+    for (; k; --k) x &= x-1;
+    int bit = 0;
+    while (!(x >> bit & 1)) ++bit;
+    return w*64+bit;
+  }
+
+  ::std::size_t size() const {
+    return _n;
+  }
+
+  ::std::size_t ones() const {
+    return _ones;
+  }
+
+private:
+  static const ::std::size_t kBlockWords = 8;
+
+  ::std::size_t _n;
+  ::std::size_t _ones = 0;
+  ::std::vector<::std::uint64_t> _words;
+  ::std::vector<::std::size_t> _blocks;
+};
+
+/**
+ * Wavelet matrix of a sequence of n bytes, answering rank queries
+ * (the occurrences of a byte in a prefix) and access in 8 steps:
+ * level l holds the bit 7-l of every byte, with the bytes stably
+ * partitioned by their higher bits (zeros first), so that the sequence
+ * takes n bits per level plus the rank counts.
+ * Runtime complexity : O(n) construction, O(1) rank and access
+ */
+class byte_wavelet_matrix {
+public:
+  byte_wavelet_matrix() = default;
+
+  explicit byte_wavelet_matrix(::std::vector<unsigned char> s) : _n(s.size()) {
+    ::std::vector<unsigned char> next(_n);
+    for (int l=0; l<kLevels; ++l) {
+      int bit = kLevels-1-l;
+      _levels[l] = rank_bitvector(_n);
+      ::std::size_t zeros = 0;
+      for (::std::size_t i=0; i<_n; ++i) {
+        if (s[i] >> bit & 1) _levels[l].set(i);
+        else next[zeros++] = s[i];
+      }
+      _levels[l].build();
+      _zeros[l] = zeros;
+      for (::std::size_t i=0, ones=zeros; i<_n; ++i) {
+        if (s[i] >> bit & 1) next[ones++] = s[i];
+      }
+      s.swap(next);
+    }
+  }
+
+  /**
+   * Return the number of occurrences of c in [0,i), for i <= n.
+   */
+  ::std::size_t rank(unsigned char c, ::std::size_t i) const {
+    ::std::size_t b = 0;
+    for (int l=0; l<kLevels; ++l) {
+      if (c >> (kLevels-1-l) & 1) {
+        b = _zeros[l]+_levels[l].rank1(b);
+        i = _zeros[l]+_levels[l].rank1(i);
+      } else {
+        b = _levels[l].rank0(b);
+        i = _levels[l].rank0(i);
+      }
+    }
+    return i-b;
+  }
+
+  unsigned char operator[](::std::size_t i) const {
+    unsigned char c = 0;
+    for (int l=0; l<kLevels; ++l) {
+      bool one = _levels[l][i];
+      c = c << 1 | one;
+      i = one ? _zeros[l]+_levels[l].rank1(i) : _levels[l].rank0(i);
+    }
+    return c;
+  }
+
+  ::std::size_t size() const {
+    return _n;
+  }
+
+private:
+  static const int kLevels = 8;
+
+  ::std::size_t _n = 0;
+  ::std::array<rank_bitvector, kLevels> _levels;
+  ::std::array<::std::size_t, kLevels> _zeros{};
+};
+
+/**
+ * Compressed full-text index of a text t of n characters (FM-index):
+ * the Burrows-Wheeler transform of t, with a sentinel smaller than
+ * every character, is stored in a byte wavelet matrix, and the rows
+ * of the sorted suffixes whose text position is a multiple of sample
+ * keep their position, marked in a rank bitvector.
+ * The occurrences of a pattern of m characters are counted by backward
+ * search, and each of them is located by walking back through the text
+ * (LF mapping) to a sampled row, at most sample-1 steps away.
+ * Unlike suffix_index, t is not needed after the construction,
+ * and the index takes about 9n/8 bytes plus n/sample indices,
+ * instead of n indices and the text.
+ * Runtime complexity : O(n) construction,
+ *                      O(m) count, O(m + occ*sample + occ*logocc) locate
+ */
+template <typename Index = int>
+class fm_index {
+public:
+  explicit fm_index(const ::std::string &t, Index sample = 32) : _n(t.size()), _sample(sample), _sampled(t.size()+1) {
+    ::std::vector<Index> sa = suffix_array<Index>(t);
+    // row 0 is the suffix made of the sentinel alone
+    ::std::vector<unsigned char> bwt(_n+1);
+    bwt[0] = _n ? t[_n-1] : 0;
+    _sampled.set(0);
+    for (Index r=1; r<=_n; ++r) {
+      Index p = sa[r-1];
+      if (p == 0) _dollar = r;
+      bwt[r] = p ? t[p-1] : 0;
+      if (p%_sample == 0) _sampled.set(r);
+    }
+    _sampled.build();
+    _samples.reserve(_sampled.ones());
+    _samples.push_back(_n);
+    for (Index r=1; r<=_n; ++r) {
+      if (sa[r-1]%_sample == 0) _samples.push_back(sa[r-1]);
+    }
+    ::std::vector<Index>().swap(sa);
+
+    _c[0] = 1;
+    for (unsigned char c : t) ++_c[c+1];
+    for (int c=0; c<kAlphabet; ++c) _c[c+1] += _c[c];
+    _bwt = byte_wavelet_matrix(::std::move(bwt));
+  }
+
+  /**
+   * Return the range [b,e) of the sorted suffixes starting with p.
+   */
+  ::std::pair<::std::size_t, ::std::size_t> range(const ::std::string &p) const {
+    ::std::size_t b = 0, e = _n+1;
+    for (auto it=p.rbegin(); it!=p.rend() && b<e; ++it) {
+      unsigned char c = *it;
+      b = _c[c]+rank(c, b);
+      e = _c[c]+rank(c, e);
+    }
+    return {b, ::std::max(b, e)};
+  }
+
+  /**
+   * Return the number of occurrences of p in t
+   * (an empty p occurs at every position, from 0 to n).
+   */
+  ::std::size_t count(const ::std::string &p) const {
+    auto r = range(p);
+    return r.second-r.first;
+  }
+
+  /**
+   * Return the starting positions of the occurrences of p in t, in increasing order.
+   */
+  ::std::vector<Index> locate(const ::std::string &p) const {
+    auto r = range(p);
+    ::std::vector<Index> result;
+    result.reserve(r.second-r.first);
+    for (::std::size_t row=r.first; row<r.second; ++row) result.push_back(position(row));
+    ::std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  /**
+   * Return the first occurrence of p in t, or -1 if there is none.
+   */
+  Index first(const ::std::string &p) const {
+    auto r = range(p);
+    Index result = -1;
+    for (::std::size_t row=r.first; row<r.second; ++row) {
+      Index q = position(row);
+      if (result < 0 || q < result) result = q;
+    }
+    return result;
+  }
+
+  ::std::size_t size() const {
+    return _n;
+  }
+
+private:
+  static const int kAlphabet = 256;
+
+  // occurrences of c in the rows [0,r) of the BWT, not counting the sentinel
+  ::std::size_t rank(unsigned char c, ::std::size_t r) const {
+    return _bwt.rank(c, r)-(c == 0 && static_cast<::std::size_t>(_dollar) < r);
+  }
+
+  // text position of the suffix of row r
+  Index position(::std::size_t r) const {
+    Index steps = 0;
+    while (!_sampled[r]) {
+      unsigned char c = _bwt[r];
+      r = _c[c]+rank(c, r);
+      ++steps;
+    }
+    return _samples[_sampled.rank1(r)]+steps;
+  }
+
+  Index _n;
+  Index _sample;
+  // row of the suffix 0, whose BWT character is the sentinel
+  Index _dollar = 0;
+  // _c[c] is the first row of the suffixes starting with c
+  ::std::array<::std::size_t, kAlphabet+1> _c{};
+  byte_wavelet_matrix _bwt;
+  rank_bitvector _sampled;
+  ::std::vector<Index> _samples;
+};
+
+} // string
+} // algorithms
+
+#endif
@@ -0,0 +1,245 @@
+#ifndef _HEAVY_HITTERS_
+#define _HEAVY_HITTERS_
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include "parallel.hpp"
+#include "partition.hpp"
+
+namespace algorithms {
+namespace array {
+
+/**
+ * Misra-Gries summary of a stream of elements, which keeps
+ * at most k-1 counters and finds all the elements appearing
+ * more than n/k times among the n elements seen so far.
+ * The counters live in a fixed-size open-addressed table
+ * (linear probing, no allocation after construction).
+ * When a new element does not fit in a full table,
+ * all counters are decremented (as if k distinct elements,
+ * the new one included, were thrown away), and the table is compacted.
+ * Every such step discards k elements, hence it happens
+ * at most n/k times, and if c is the real count of an element
+ * and e its estimate, e <= c <= e + error() <= e + n/k.
+ * Runtime complexity : O(1) amortized per element, O(k) space
+ */
+template <typename T, typename Hash = ::std::hash<T>>
+class misra_gries {
+public:
+  explicit misra_gries(int k) :
+    _k(k), _capacity(capacity(k)),
+    _keys(_capacity), _counts(_capacity, 0), _size(0), _n(0), _error(0) {
+    _scratch.reserve(_capacity);
+  };
+
+  /**
+   * Add one occurrence of x.
+   */
+  void add(const T &x) {
+    ++_n;
+    ::std::size_t i = find(x);
+    if (_counts[i]) ++_counts[i];
+    else if (_size < _k-1) {
+      _keys[i] = x;
+      _counts[i] = 1;
+      ++_size;
+    }
+    else decrement(1);
+  }
+
+  /**
+   * Add all the elements in the range [first,last).
+   */
+  template <typename InputIt>
+  void add(InputIt first, InputIt last) {
+    for (; first!=last; ++first) add(*first);
+  }
+
+  /**
+   * Merge the summary of another stream (built with the same k) into this one,
+   * so that this becomes a summary of the concatenation of the two streams
+   * with the same guarantees (Agarwal et al., mergeable summaries):
+   * the counters of both summaries are inserted into an empty table,
+   * and whenever one does not fit, it and all the counters in the table
+   * are decremented by the smallest of them.
+   */
+  void merge(const misra_gries &other) {
+    auto entries = this->entries();
+    auto more = other.entries();
+    _n += other._n;
+    _error += other._error;
+    clear();
+    for (auto &e : entries) insert(e.first, e.second);
+    for (auto &e : more) insert(e.first, e.second);
+  }
+
+  /**
+   * Return the (element,estimated count) pairs currently in the summary.
+   * Every element appearing more than n/k times is among them.
+   */
+  ::std::vector<::std::pair<T,long long>> entries() const {
+    ::std::vector<::std::pair<T,long long>> result;
+    result.reserve(_size);
+    for (::std::size_t i=0; i<_capacity; ++i) {
+      if (_counts[i]) result.emplace_back(_keys[i], _counts[i]);
+    }
+    return result;
+  }
+
+  /**
+   * Return a lower bound of the number of occurrences of x seen so far.
+   * The real count is at most estimate(x)+error().
+   */
+  long long estimate(const T &x) const {
+    return _counts[find(x)];
+  }
+
+  /**
+   * Return the heavy hitters of the stream seen so far:
+   * the elements that may appear more than n/k times,
+   * that is, whose upper bound estimate(x)+error() exceeds n/k.
+   * There are no false negatives, and false positives
+   * appear at most n/k - error() times.
+   */
+  ::std::vector<T> heavy_hitters() const {
+    ::std::vector<T> result;
+    for (::std::size_t i=0; i<_capacity; ++i) {
+      if (_counts[i] && (_counts[i]+_error)*_k > _n) result.push_back(_keys[i]);
+    }
+    return result;
+  }
+
+  long long size() const { return _n; }
+  long long error() const { return _error; }
+  int k() const { return _k; }
+
+private:
+  static ::std::size_t capacity(int k) {
+    ::std::size_t c = 1;
+    while (c < 2*static_cast<::std::size_t>(::std::max(k-1,1))) c <<= 1;
+    return c;
+  }
+
+  // slot holding x, or the empty slot where x would go
+  ::std::size_t find(const T &x) const {
+    ::std::size_t i = _hash(x) & (_capacity-1);
+    while (_counts[i] && !(_keys[i] == x)) i = (i+1) & (_capacity-1);
+    return i;
+  }
+
+  // add c occurrences of x, without counting them in n
+  void insert(const T &x, long long c) {
+    ::std::size_t i = find(x);
+    if (_counts[i]) _counts[i] += c;
+    else if (_size < _k-1) {
+      _keys[i] = x;
+      _counts[i] = c;
+      ++_size;
+    }
+    else {
+      // x and the k-1 counters are k distinct elements
+      long long m = c;
+      for (::std::size_t j=0; j<_capacity; ++j) if (_counts[j]) m = ::std::min(m, _counts[j]);
+      decrement(m);
+      if (c > m) insert(x, c-m);
+    }
+  }
+
+  // decrement all the counters by d and drop the ones reaching 0
+  void decrement(long long d) {
+    _error += d;
+    _scratch.clear();
+    for (::std::size_t i=0; i<_capacity; ++i) {
+      if (_counts[i]) _scratch.emplace_back(_keys[i], _counts[i]);
+    }
+    clear();
+    for (auto &e : _scratch) {
+      if (e.second > d) {
+        ::std::size_t i = find(e.first);
+        _keys[i] = e.first;
+        _counts[i] = e.second-d;
+        ++_size;
+      }
+    }
+  }
+
+  void clear() {
+    ::std::fill(_counts.begin(), _counts.end(), 0);
+    _size = 0;
+  }
+
+  int _k;
+  ::std::size_t _capacity;
+  ::std::vector<T> _keys;
+  ::std::vector<long long> _counts;
+  int _size;
+  long long _n;
+  long long _error;
+  Hash _hash;
+  ::std::vector<::std::pair<T,long long>> _scratch;
+};
+
+/**
+ * Count the occurrences in [first,last) of each of the m candidates
+ * starting at cand, adding them to the counts starting at counts.
+ * The loop runs over the candidates and then over the elements with
+ * a branchless comparison, so that for arithmetic types
+ * the compiler can vectorize it.
+ * Runtime complexity : O(n*m)
+ */
+template <typename ForwardIt, typename T>
+void count_candidates(ForwardIt first, ForwardIt last,
+                      const T *cand, ::std::size_t m, long long *counts) {
+  for (::std::size_t c=0; c<m; ++c) {
+    long long count = 0;
+    const T x = cand[c];
+    for (auto it=first; it!=last; ++it) count += (*it == x);
+    counts[c] += count;
+  }
+}
+
+/**
+ * Given an array of n elements, find all the elements
+ * appearing more than n/k times, in increasing order, on t threads
+ * (0 means one per hardware thread).
+ * Each thread builds the Misra-Gries summary of a chunk of the array,
+ * the summaries are merged, and the (at most k-1) candidates
+ * are verified by counting them exactly, again in parallel.
+ * Runtime complexity : O(n*k/t + k*t)
+ */
+template <typename RandomIt>
+::std::vector<typename ::std::iterator_traits<RandomIt>::value_type>
+heavy_hitters(RandomIt first, RandomIt last, int k, unsigned t = 0) {
+  using value_type = typename ::std::iterator_traits<RandomIt>::value_type;
+  ::std::size_t n = last-first;
+  ::std::size_t c = parallel::chunks(n, t, kParallelMinChunk);
+  ::std::vector<misra_gries<value_type>> summaries(c, misra_gries<value_type>(k));
+  parallel::for_chunks(n, t, kParallelMinChunk, [&](::std::size_t i, ::std::size_t b, ::std::size_t e) {
+    summaries[i].add(first+b, first+e);
+  });
+  for (::std::size_t i=1; i<c; ++i) summaries[0].merge(summaries[i]);
+
+  ::std::vector<value_type> cand;
+  for (auto &e : summaries[0].entries()) cand.push_back(e.first);
+  ::std::vector<long long> counts(c*cand.size(), 0);
+  parallel::for_chunks(n, t, kParallelMinChunk, [&](::std::size_t i, ::std::size_t b, ::std::size_t e) {
+    count_candidates(first+b, first+e, cand.data(), cand.size(), counts.data()+i*cand.size());
+  });
+
+  ::std::vector<value_type> result;
+  for (::std::size_t j=0; j<cand.size(); ++j) {
+    long long count = 0;
+    for (::std::size_t i=0; i<c; ++i) count += counts[i*cand.size()+j];
+    if (count*k > static_cast<long long>(n)) result.push_back(cand[j]);
+  }
+  ::std::sort(result.begin(), result.end());
+  return result;
+}
+
+} // array
+} // algorithms
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef _JUMP_INDEX_
+#define _JUMP_INDEX_
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace algorithms {
+namespace array {
+
+/**
+ * Index over an array of n integers a, where a[p] denotes
+ * the maximum you can advance from index p (as in can_reach_end),
+ * answering queries on the minimum number of steps from i to j.
+ * As in can_reach_end, the indices reachable from i with k steps
+ * form a block [i,R_k], and R_{k+1} is the farthest reach p+a[p]
+ * of an index p in [i,R_k]. The same block is reached by always
+ * jumping from p to the index g(p) of the farthest reach in [p,p+a[p]]
+ * (the greedy next-frontier pointer): R_k is the reach of g^{k-1}(i),
+ * which grows with k, so that the number of steps to j is found
+ * by binary lifting over the pointers g^{2^l}.
+ * The pointers of each index are stored contiguously, as 32-bit
+ * indices (n must be less than 2^32), so that the levels
+ * of the same index visited by a query share cache lines.
+ * Runtime complexity : O(nlogn) construction, O(logn) per query
+ */
+class jump_index {
+public:
+  template <typename RandomIt>
+  jump_index(RandomIt first, RandomIt last) : _n(last-first), _levels(1) {
+    if (_n == 0) return;
+    while ((::std::size_t(1) << _levels) < _n) ++_levels;
+    _reach.resize(_n);
+    for (::std::size_t p=0; p<_n; ++p) {
+      long long r = static_cast<long long>(p) + ::std::max<long long>(first[p], 0);
+      _reach[p] = static_cast<::std::uint32_t>(::std::min<long long>(r, _n-1));
+    }
+
+    // sparse table of the index of the farthest reach in [p,p+2^l)
+    ::std::vector<::std::vector<::std::uint32_t>> farthest{::std::vector<::std::uint32_t>(_n)};
+    for (::std::size_t p=0; p<_n; ++p) farthest[0][p] = p;
+    for (::std::size_t l=1; (::std::size_t(1) << l) <= _n; ++l) {
+      ::std::size_t h = ::std::size_t(1) << (l-1);
+      farthest.emplace_back(_n-2*h+1);
+      for (::std::size_t p=0; p+2*h<=_n; ++p) farthest[l][p] = better(farthest[l-1][p], farthest[l-1][p+h]);
+    }
+
+    _up.resize(_n*_levels);
+    for (::std::size_t p=0; p<_n; ++p) {
+      ::std::size_t len = _reach[p]-p+1, l = 0;
+      while ((::std::size_t(2) << l) <= len) ++l;
+      _up[p*_levels] = better(farthest[l][p], farthest[l][_reach[p]+1-(::std::size_t(1) << l)]);
+    }
+    for (::std::size_t l=1; l<_levels; ++l) {
+      for (::std::size_t p=0; p<_n; ++p) _up[p*_levels+l] = _up[_up[p*_levels+l-1]*_levels+l-1];
+    }
+  }
+
+  /**
+   * Return the minimum number of steps from index i to index j,
+   * or -1 if j can not be reached from i (in particular if j < i).
+   */
+  long long min_jumps(::std::size_t i, ::std::size_t j) const {
+    if (j < i || j >= _n) return -1;
+    if (i == j) return 0;
+    if (_reach[i] >= j) return 1;
+    long long m = 0;
+    for (::std::size_t l=_levels; l-->0; ) {
+      ::std::uint32_t q = _up[i*_levels+l];
+      if (_reach[q] < j) {
+        i = q;
+        m += 1LL << l;
+      }
+    }
+    return _reach[_up[i*_levels]] >= j ? m+2 : -1;
+  }
+
+  /**
+   * Answer the (i,j) queries in [first,last), writing the results starting at out.
+   * Queries are processed in groups of kBatch, advancing all of them
+   * one level at a time, so that the memory accesses of a group overlap.
+   */
+  template <typename InputIt, typename OutputIt>
+  void min_jumps_many(InputIt first, InputIt last, OutputIt out) const {
+    ::std::size_t p[kBatch], j[kBatch];
+    long long m[kBatch];
+    bool lift[kBatch];
+    while (first != last) {
+      int c = 0;
+      for (; c<kBatch && first!=last; ++c, ++first) {
+        p[c] = first->first;
+        j[c] = first->second;
+        lift[c] = j[c] < _n && p[c] < j[c] && _reach[p[c]] < j[c];
+        m[c] = 0;
+      }
+      for (::std::size_t l=_levels; l-->0; ) {
+        for (int k=0; k<c; ++k) {
+          if (!lift[k]) continue;
+          ::std::uint32_t q = _up[p[k]*_levels+l];
+          if (_reach[q] < j[k]) {
+            p[k] = q;
+            m[k] += 1LL << l;
+          }
+        }
+      }
+      for (int k=0; k<c; ++k) {
+        if (lift[k]) *out++ = _reach[_up[p[k]*_levels]] >= j[k] ? m[k]+2 : -1;
+        else *out++ = min_jumps(p[k], j[k]);
+      }
+    }
+  }
+
+  ::std::size_t size() const {
+    return _n;
+  }
+
+private:
+  static const int kBatch = 16;
+
+  ::std::uint32_t better(::std::uint32_t p, ::std::uint32_t q) const {
+    return _reach[q] > _reach[p] ? q : p;
+  }
+
+  ::std::size_t _n;
+  ::std::size_t _levels;
+  ::std::vector<::std::uint32_t> _reach;
+  // _up[p*_levels+l] = g^{2^l}(p)
+  ::std::vector<::std::uint32_t> _up;
+};
+
+} // array
+} // algorithms
+
+#endif
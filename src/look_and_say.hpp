@@ -0,0 +1,334 @@
+#ifndef _LOOK_AND_SAY_
+#define _LOOK_AND_SAY_
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace algorithms {
+namespace string {
+
+/**
+ * One of the 92 common elements of Conway's decomposition of the
+ * look-and-say sequence: a string of digits which evolves independently
+ * of its neighbours in the terms, and whose next term is the compound
+ * of the decay elements (indices in kConwayElements).
+ */
+struct conway_element {
+  const char *digits;
+  int decay_size;
+  int decay[6];
+};
+
+const int kConwayElementCount = 92;
+
+// the elements, sorted by their digits
+constexpr conway_element kConwayElements[kConwayElementCount] = {
+  {"1112", 1, {62}},
+  {"1112133", 2, {63, 61}},
+  {"111213322112", 1, {64}},
+  {"111213322113", 1, {65}},
+  {"1113", 1, {67}},
+  {"11131", 1, {68}},
+  {"111311222112", 2, {83, 54}},
+  {"111312", 1, {69}},
+  {"11131221", 1, {70}},
+  {"1113122112", 1, {75}},
+  {"1113122113", 1, {76}},
+  {"11131221131112", 1, {81}},
+  {"111312211312", 1, {77}},
+  {"11131221131211", 1, {78}},
+  {"111312211312113211", 1, {79}},
+  {"111312211312113221133211322112211213322112", 3, {80, 28, 89}},
+  {"111312211312113221133211322112211213322113", 3, {80, 28, 90}},
+  {"11131221131211322113322112", 2, {80, 29}},
+  {"11131221133112", 3, {74, 28, 91}},
+  {"1113122113322113111221131221", 2, {74, 31}},
+  {"11131221222112", 1, {71}},
+  {"111312212221121123222112", 1, {72}},
+  {"111312212221121123222113", 1, {73}},
+  {"11132", 1, {82}},
+  {"1113222", 1, {85}},
+  {"1113222112", 1, {86}},
+  {"1113222113", 1, {87}},
+  {"11133112", 2, {88, 91}},
+  {"12", 1, {0}},
+  {"123222112", 1, {2}},
+  {"123222113", 1, {3}},
+  {"12322211331222113112211", 4, {1, 60, 28, 84}},
+  {"13", 1, {4}},
+  {"131112", 1, {27}},
+  {"13112221133211322112211213322112", 5, {23, 32, 60, 28, 89}},
+  {"13112221133211322112211213322113", 5, {23, 32, 60, 28, 90}},
+  {"13122112", 1, {6}},
+  {"132", 1, {7}},
+  {"13211", 1, {8}},
+  {"132112", 1, {9}},
+  {"1321122112", 1, {20}},
+  {"132112211213322112", 1, {21}},
+  {"132112211213322113", 1, {22}},
+  {"132113", 1, {10}},
+  {"1321131112", 1, {18}},
+  {"13211312", 1, {11}},
+  {"1321132", 1, {12}},
+  {"13211321", 1, {13}},
+  {"132113212221", 1, {14}},
+  {"13211321222113222112", 1, {17}},
+  {"1321132122211322212221121123222112", 1, {15}},
+  {"1321132122211322212221121123222113", 1, {16}},
+  {"13211322211312113211", 1, {19}},
+  {"1321133112", 4, {5, 60, 28, 91}},
+  {"1322112", 1, {25}},
+  {"1322113", 1, {26}},
+  {"13221133112", 3, {24, 28, 91}},
+  {"1322113312211", 3, {24, 28, 66}},
+  {"132211331222113112211", 3, {24, 28, 84}},
+  {"13221133122211332", 6, {24, 28, 67, 60, 28, 88}},
+  {"22", 1, {60}},
+  {"3", 1, {32}},
+  {"3112", 1, {39}},
+  {"3112112", 1, {40}},
+  {"31121123222112", 1, {41}},
+  {"31121123222113", 1, {42}},
+  {"3112221", 2, {37, 38}},
+  {"3113", 1, {43}},
+  {"311311", 1, {47}},
+  {"31131112", 1, {53}},
+  {"3113112211", 1, {48}},
+  {"3113112211322112", 1, {49}},
+  {"3113112211322112211213322112", 1, {50}},
+  {"3113112211322112211213322113", 1, {51}},
+  {"311311222", 2, {46, 37}},
+  {"311311222112", 2, {46, 54}},
+  {"311311222113", 2, {46, 55}},
+  {"3113112221131112", 2, {46, 56}},
+  {"311311222113111221", 2, {46, 57}},
+  {"311311222113111221131221", 2, {46, 58}},
+  {"31131122211311122113222", 2, {46, 59}},
+  {"3113112221133112", 5, {46, 32, 60, 28, 91}},
+  {"311312", 1, {44}},
+  {"31132", 1, {45}},
+  {"311322113212221", 1, {52}},
+  {"311332", 3, {37, 28, 88}},
+  {"3113322112", 2, {37, 29}},
+  {"3113322113", 2, {37, 30}},
+  {"312", 1, {33}},
+  {"312211322212221121123222112", 1, {34}},
+  {"312211322212221121123222113", 1, {35}},
+  {"32112", 1, {36}}
+};
+
+// the first term which is a compound of elements, 11132.13211
+const int kConwayStart = 8;
+constexpr int kConwayStartElements[] = {23, 38};
+
+// the last term whose length fits in 64 bits
+const int kMaxLookAndSay = 165;
+
+/**
+ * Term n of the look-and-say sequence (see look_and_say), for n from 1
+ * to kMaxLookAndSay, which is not materialized: from term kConwayStart on,
+ * a term is a compound of Conway's elements, each of them decaying into
+ * the elements of the next term independently of the others, so that
+ * term n is the leaves of a tree of depth n-kConwayStart, whose nodes
+ * are elements. The lengths of the elements after m steps are tabulated,
+ * and used to find the element holding a given position of the term,
+ * descending the tree from its root.
+ * Throws ::std::runtime_error for n above kMaxLookAndSay,
+ * whose length would wrap.
+ * Runtime complexity : O(n) construction and space, O(n) per position
+ */
+class look_and_say_term {
+public:
+  explicit look_and_say_term(int n) : _n(n) {
+    if (_n > kMaxLookAndSay) throw ::std::runtime_error("look-and-say term too long");
+    if (_n < kConwayStart) {
+      _small = "1";
+      for (int i=1; i<_n; ++i) _small = next_helper(_small);
+      return;
+    }
+    int steps = _n-kConwayStart;
+    _len.resize((steps+1)*kConwayElementCount);
+    for (int e=0; e<kConwayElementCount; ++e) _len[e] = ::std::strlen(kConwayElements[e].digits);
+    for (int m=1; m<=steps; ++m) {
+      for (int e=0; e<kConwayElementCount; ++e) {
+        unsigned long long l = 0;
+        for (int k=0; k<kConwayElements[e].decay_size; ++k) l += length(kConwayElements[e].decay[k], m-1);
+        _len[m*kConwayElementCount+e] = l;
+      }
+    }
+  }
+
+  /**
+   * Return the number of digits of the term.
+   * Runtime complexity : O(1)
+   */
+  unsigned long long size() const {
+    if (_n < kConwayStart) return _small.size();
+    unsigned long long l = 0;
+    for (int e : kConwayStartElements) l += length(e, _n-kConwayStart);
+    return l;
+  }
+
+  /**
+   * Return the number of times each element appears in the term
+   * (all 0 before kConwayStart), as counted by propagating the counts
+   * of the elements through their decays.
+   * Runtime complexity : O(n)
+   */
+  ::std::vector<unsigned long long> composition() const {
+    ::std::vector<unsigned long long> count(kConwayElementCount, 0), next(kConwayElementCount);
+    if (_n < kConwayStart) return count;
+    for (int e : kConwayStartElements) ++count[e];
+    for (int m=kConwayStart; m<_n; ++m) {
+      ::std::fill(next.begin(), next.end(), 0);
+      for (int e=0; e<kConwayElementCount; ++e) {
+        for (int k=0; k<kConwayElements[e].decay_size; ++k) next[kConwayElements[e].decay[k]] += count[e];
+      }
+      count.swap(next);
+    }
+    return count;
+  }
+
+  /**
+   * Return the digit at position i (from 0) of the term.
+   */
+  char operator[](unsigned long long i) const {
+    char c = 0;
+    visit(i, [&](const char *p, ::std::size_t) {
+      c = *p;
+      return false;
+    });
+    return c;
+  }
+
+  /**
+   * Write the (at most) count digits of the term from position pos
+   * starting at out, and return the end of the written digits.
+   * Runtime complexity : O(n+count)
+   */
+  template <typename OutputIt>
+  OutputIt write(unsigned long long pos, unsigned long long count, OutputIt out) const {
+    if (count == 0) return out;
+    visit(pos, [&](const char *p, ::std::size_t l) {
+      l = ::std::min<unsigned long long>(l, count);
+      out = ::std::copy(p, p+l, out);
+      count -= l;
+      return count > 0;
+    });
+    return out;
+  }
+
+  /**
+   * Write the whole term to sink, a function called as
+   * sink(const char *digits, std::size_t size) on consecutive chunks of
+   * at most chunk digits, so that the memory used is O(n+chunk) for any
+   * length of the term.
+   * Runtime complexity : O(size())
+   */
+  template <typename Sink>
+  void stream(Sink sink, ::std::size_t chunk = 1<<16) const {
+    ::std::vector<char> buffer(chunk);
+    ::std::size_t used = 0;
+    visit(0, [&](const char *p, ::std::size_t l) {
+      while (l) {
+        ::std::size_t c = ::std::min(l, chunk-used);
+        ::std::copy(p, p+c, buffer.data()+used);
+        used += c;
+        p += c;
+        l -= c;
+        if (used == chunk) {
+          sink(static_cast<const char *>(buffer.data()), used);
+          used = 0;
+        }
+      }
+      return true;
+    });
+    if (used) sink(static_cast<const char *>(buffer.data()), used);
+  }
+
+private:
+  // the term after s, by reading its runs
+  static ::std::string next_helper(const ::std::string &s) {
+    ::std::string next;
+    for (::std::size_t j=0; j<s.size();) {
+      ::std::size_t k = j;
+      while (k<s.size() && s[k]==s[j]) ++k;
+      next.append(::std::to_string(k-j)).push_back(s[j]);
+      j = k;
+    }
+    return next;
+  }
+
+  struct frame {
+    int e;
+    int m;
+    int next;
+  };
+
+  unsigned long long length(int e, int m) const {
+    return _len[m*kConwayElementCount+e];
+  }
+
+  // call emit(digits, size) on the consecutive pieces of the term
+  // from position pos, until it returns false or the term ends
+  template <typename F>
+  void visit(unsigned long long pos, F emit) const {
+    if (_n < kConwayStart) {
+      if (pos < _small.size()) emit(_small.data()+pos, _small.size()-pos);
+      return;
+    }
+    // the root, whose children are the elements of term kConwayStart
+    ::std::vector<frame> stack{{-1, _n-kConwayStart+1, 0}};
+    // skip the subtrees before pos
+    while (true) {
+      frame &f = stack.back();
+      if (f.m == 0) break;
+      int size = f.e < 0 ? 2 : kConwayElements[f.e].decay_size;
+      while (f.next < size) {
+        int c = child(f, f.next);
+        unsigned long long l = length(c, f.m-1);
+        if (pos < l) break;
+        pos -= l;
+        ++f.next;
+      }
+      if (f.next == size) return;
+      int c = child(f, f.next++);
+      stack.push_back({c, f.m-1, 0});
+    }
+    const char *digits = kConwayElements[stack.back().e].digits;
+    if (!emit(digits+pos, length(stack.back().e, 0)-pos)) return;
+    stack.pop_back();
+    // then emit the leaves, in order
+    while (!stack.empty()) {
+      frame &f = stack.back();
+      int size = f.e < 0 ? 2 : kConwayElements[f.e].decay_size;
+      if (f.next == size) {
+        stack.pop_back();
+      } else if (f.m == 1) {
+        int c = child(f, f.next++);
+        if (!emit(kConwayElements[c].digits, length(c, 0))) return;
+      } else {
+        int c = child(f, f.next++);
+        stack.push_back({c, f.m-1, 0});
+      }
+    }
+  }
+
+  static int child(const frame &f, int k) {
+    return f.e < 0 ? kConwayStartElements[k] : kConwayElements[f.e].decay[k];
+  }
+
+  int _n;
+  // the terms before kConwayStart
+  ::std::string _small;
+  // _len[m*kConwayElementCount+e] = length of the element e after m steps
+  ::std::vector<unsigned long long> _len;
+};
+
+} // string
+} // algorithms
+
+#endif
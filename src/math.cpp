@@ -1,35 +1,205 @@
 #include "math.hpp"
+#include "parallel.hpp"
+#include "partition.hpp"
 #include <algorithm>
-#include <cmath>
+#include <cstdlib>
+#include <numeric>
 
 namespace algorithms {
 namespace math {
 
 /*********** min_total_distance *************/
+namespace {
+using array::kParallelMinChunk;
+
+inline int popcount(::std::uint64_t w) {
+#if defined(__GNUC__)
+  return __builtin_popcountll(w);
+#else
+  int c = 0;
+  for (; w; w &= w-1) ++c;
+  return c;
+#endif
+}
+
+inline int lowest_bit(::std::uint64_t w) {
+#if defined(__GNUC__)
+  return __builtin_ctzll(w);
+#else
+  int i = 0;
+  for (; !(w & 1); w >>= 1) ++i;
+  return i;
+#endif
+}
+
+/**
+ * Return the minimum over m of sum_h hist[h]*|h-m|,
+ * which is attained at a (weighted) median of the histogram.
+ */
+long long median_distance(const ::std::vector<long long> &hist) {
+  long long total = ::std::accumulate(hist.begin(), hist.end(), 0LL), cum = 0, d = 0;
+  long long m = 0, n = hist.size();
+  while (m < n && 2*(cum += hist[m]) < total) ++m;
+  for (long long h=0; h<n; ++h) d += hist[h]*::std::abs(h-m);
+  return d;
+}
+
+// add up the per chunk histograms into the first one, on t threads
+void reduce_histograms(::std::vector<::std::vector<long long>> *hists, unsigned t) {
+  auto &h = *hists;
+  parallel::for_chunks(h[0].size(), t, kParallelMinChunk, [&](::std::size_t, ::std::size_t b, ::std::size_t e) {
+    for (::std::size_t c=1; c<h.size(); ++c) {
+      for (::std::size_t i=b; i<e; ++i) h[0][i] += h[c][i];
+    }
+  });
+}
+
+template <typename Weight>
+long long min_total_distance_helper(const ::std::vector<::std::pair<int,int>> &points,
+                                    int rows, int cols, unsigned t, Weight weight) {
+  ::std::size_t n = points.size();
+  ::std::size_t c = parallel::chunks(n, t, kParallelMinChunk);
+  ::std::vector<::std::vector<long long>> xs(c, ::std::vector<long long>(rows, 0));
+  ::std::vector<::std::vector<long long>> ys(c, ::std::vector<long long>(cols, 0));
+  parallel::for_chunks(n, t, kParallelMinChunk, [&](::std::size_t i, ::std::size_t b, ::std::size_t e) {
+    auto &x = xs[i];
+    auto &y = ys[i];
+    for (::std::size_t j=b; j<e; ++j) {
+      long long w = weight(j);
+      x[points[j].first] += w;
+      y[points[j].second] += w;
+    }
+  });
+  reduce_histograms(&xs, t);
+  reduce_histograms(&ys, t);
+  return median_distance(xs[0])+median_distance(ys[0]);
+}
+} // anonymous
+
 int min_total_distance(const ::std::vector<::std::vector<int>> &grid) {
-  ::std::vector<int> x,y;
-  for (int i=0; i<grid.size(); ++i) {
-    for (int j=0; j<grid[0].size(); ++j) {
-      if (grid[i][j]) {x.push_back(i); y.push_back(j);};
+  if (grid.empty()) return 0;
+  ::std::vector<long long> x(grid.size(), 0), y(grid[0].size(), 0);
+  for (::std::size_t i=0; i<grid.size(); ++i) {
+    for (::std::size_t j=0; j<grid[i].size(); ++j) {
+      long long home = grid[i][j] != 0;
+      x[i] += home;
+      y[j] += home;
     }
   }
-  ::std::nth_element(x.begin(), x.begin() + x.size()/2, x.end());
-  ::std::nth_element(y.begin(), y.begin() + y.size()/2, y.end());
-  int mx = x[x.size()/2], my = y[y.size()/2], d = 0;
-  ::std::for_each(x.begin(),x.end(),[&](const int xx){d += abs(xx-mx);});
-  ::std::for_each(y.begin(),y.end(),[&](const int yy){d += abs(yy-my);});
-  return d;  
+  return median_distance(x)+median_distance(y);
+}
+
+long long min_total_distance(const ::std::vector<::std::pair<int,int>> &points,
+                             int rows, int cols, unsigned t) {
+  return min_total_distance_helper(points, rows, cols, t, [](::std::size_t) { return 1LL; });
+}
+
+long long min_total_distance(const ::std::vector<::std::pair<int,int>> &points,
+                             const ::std::vector<long long> &weights,
+                             int rows, int cols, unsigned t) {
+  return min_total_distance_helper(points, rows, cols, t, [&](::std::size_t j) { return weights[j]; });
+}
+
+long long min_total_distance(const ::std::vector<::std::uint64_t> &bits,
+                             int rows, int cols, unsigned t) {
+  ::std::size_t words = (cols+63)/64;
+  // the padding bits of the last word of every row are ignored
+  ::std::uint64_t last_mask = cols%64 ? (::std::uint64_t(1) << cols%64)-1 : ~::std::uint64_t(0);
+  ::std::size_t min_rows = ::std::max<::std::size_t>(1, kParallelMinChunk/::std::max<::std::size_t>(1, words));
+  ::std::size_t c = parallel::chunks(rows, t, min_rows);
+  ::std::vector<long long> x(rows, 0);
+  ::std::vector<::std::vector<long long>> ys(c, ::std::vector<long long>(cols, 0));
+  parallel::for_chunks(rows, t, min_rows, [&](::std::size_t i, ::std::size_t b, ::std::size_t e) {
+    auto &y = ys[i];
+    for (::std::size_t r=b; r<e; ++r) {
+      const ::std::uint64_t *row = bits.data()+r*words;
+      long long count = 0;
+      for (::std::size_t k=0; k<words; ++k) {
+        ::std::uint64_t word = k+1 < words ? row[k] : row[k] & last_mask;
+        count += popcount(word);
+        for (::std::uint64_t w=word; w; w &= w-1) ++y[64*k+lowest_bit(w)];
+      }
+      x[r] = count;
+    }
+  });
+  reduce_histograms(&ys, t);
+  return median_distance(x)+median_distance(ys[0]);
+}
+
+/*********** isqrt *************/
+::std::uint64_t isqrt(::std::uint64_t n) {
+  if (n < 2) return n;
+  int bits = 0;
+  for (::std::uint64_t m=n; m; m >>= 1) ++bits;
+  // 2^ceil(bits/2) >= sqrt(n)
+  ::std::uint64_t x = ::std::uint64_t(1) << (bits+1)/2;
+  for (::std::uint64_t y=(x+n/x)/2; y<x; y=(x+n/x)/2) x = y;
+  return x;
 }
 
 /*********** n_lockers *************/
-int n_lockers(int n) {
+long long n_lockers(long long n) {
   /**
    * The only slots being open/closed an odd number of times
    * are the ones that can be decomposed as a product of 
    * a factor by itself, that is, the perfect squares.
    * There are precisely floor(sqrt(n)) of them in the range 1..n
    */
-  return ::std::floor(::std::sqrt(n));
+  return n > 0 ? isqrt(n) : 0;
+}
+
+/*********** simulate_lockers *************/
+namespace {
+const int kMaskStrides = 64;
+// 2^12 words, 32KB per block, fits in the L1 cache
+const ::std::uint64_t kLockerBlock = 1<<12;
+
+// masks[s][j] has bit k set iff 64*j+k is a multiple of s, for j < s
+const ::std::vector<::std::vector<::std::uint64_t>> &locker_masks() {
+  static const ::std::vector<::std::vector<::std::uint64_t>> masks = [] {
+    ::std::vector<::std::vector<::std::uint64_t>> m(kMaskStrides+1);
+    for (int s=1; s<=kMaskStrides; ++s) {
+      m[s].assign(s, 0);
+      for (int b=0; b<64*s; b+=s) m[s][b/64] |= ::std::uint64_t(1) << b%64;
+    }
+    return m;
+  }();
+  return masks;
+}
+
+// toggle the multiples of s in (lo,n] within the words [wb,we)
+void toggle_multiples(::std::uint64_t *words, ::std::uint64_t wb, ::std::uint64_t we,
+                      ::std::uint64_t s, ::std::uint64_t lo, ::std::uint64_t n) {
+  ::std::uint64_t first = ::std::max(lo+1, 64*wb), last = ::std::min(n+1, 64*we);
+  if (first >= last) return;
+  if (s > kMaskStrides) {
+    for (::std::uint64_t k=(first+s-1)/s*s; k<last; k+=s) words[k/64] ^= ::std::uint64_t(1) << k%64;
+    return;
+  }
+  const ::std::vector<::std::uint64_t> &mask = locker_masks()[s];
+  ::std::uint64_t fw = first/64, lw = (last-1)/64, j = fw%s;
+  for (::std::uint64_t w=fw; w<=lw; ++w) {
+    ::std::uint64_t m = mask[j];
+    if (w == fw) m &= ~::std::uint64_t(0) << first%64;
+    if (w == lw && last%64) m &= ~(~::std::uint64_t(0) << last%64);
+    words[w] ^= m;
+    if (++j == s) j = 0;
+  }
+}
+} // anonymous
+
+::std::vector<::std::uint64_t> simulate_lockers(::std::uint64_t n, unsigned t) {
+  ::std::vector<::std::uint64_t> words(n/64+1, 0);
+  ::std::uint64_t s = isqrt(n), q = s ? n/s : 0;
+  ::std::size_t blocks = (words.size()+kLockerBlock-1)/kLockerBlock;
+  parallel::for_chunks(blocks, t, 1, [&](::std::size_t, ::std::size_t b, ::std::size_t e) {
+    for (::std::size_t k=b; k<e; ++k) {
+      ::std::uint64_t wb = k*kLockerBlock, we = ::std::min<::std::uint64_t>(wb+kLockerBlock, words.size());
+      for (::std::uint64_t i=1; i<=s; ++i) toggle_multiples(words.data(), wb, we, i, 0, n);
+      for (::std::uint64_t i=1; i<=q; ++i) toggle_multiples(words.data(), wb, we, i, i*s, n);
+    }
+  });
+  return words;
 }
 
 /*********** add_without_plus *************/
@@ -39,20 +209,19 @@ int add_without_plus(int a, int b) {
    * where a^b represents the addition of a and b
    * without considering the carries,
    * and (a&b)<<1 represents the carries.
+   * Rather than iterating until the carries settle (up to 32 times),
+   * all of them are computed at once by carries_helper, on unsigned
+   * values, since shifting negative ints is undefined.
    */
-  while(b) {
-    int tmp = a;
-    a ^= b;
-    b = (tmp&b)<<1;
-  }
-  return a;
+  unsigned x = a, y = b;
+  return static_cast<int>(x ^ y ^ carries_helper(x, y));
 }
 
 /*********** number_of_twos *************/
-int number_of_twos(int n) {
-  int count=0;
-  //TODO
-  return count;
+long long number_of_twos(int n) {
+  if (n < 0) return 0;
+  static const digit_counter<> twos(10, 2);
+  return twos.count(n);
 }
 
 } // math
@@ -1,6 +1,11 @@
 #ifndef _ALGOMATH_
 #define _ALGOMATH_
+#include <algorithm>
 #include <vector>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
 
 namespace algorithms {
 namespace math {
@@ -12,10 +17,55 @@ namespace math {
  * where each 1 marks the home of someone in the group. 
  * The distance is calculated using Manhattan Distance, 
  * where distance(p1, p2) = |p2.x - p1.x| + |p2.y - p1.y|.
+ * The distances along the two axes are independent, and each is minimized
+ * by meeting at a median of the projections of the homes on that axis,
+ * which is found by counting the homes on each row and on each column.
  * Runtime complexity : O(n)
  */
 int min_total_distance(const ::std::vector<::std::vector<int>> &grid);
 
+/**
+ * Sparse overload of min_total_distance, for a rows x cols grid
+ * whose homes are given as a list of n (row,column) points,
+ * projected on the axes on t threads (0 means one per hardware thread),
+ * each counting a chunk of the points.
+ * Runtime complexity : O(rows+cols+n/t)
+ */
+long long min_total_distance(const ::std::vector<::std::pair<int,int>> &points,
+                             int rows, int cols, unsigned t = 0);
+
+/**
+ * Weighted overload of min_total_distance: points[i] is the home
+ * of weights[i] (non-negative) people, and the meeting point is
+ * at the weighted medians of the projections.
+ * Runtime complexity : O(rows+cols+n/t)
+ */
+long long min_total_distance(const ::std::vector<::std::pair<int,int>> &points,
+                             const ::std::vector<long long> &weights,
+                             int rows, int cols, unsigned t = 0);
+
+/**
+ * Bit-packed overload of min_total_distance, for a dense rows x cols grid
+ * stored row by row, each row in (cols+63)/64 64-bit words,
+ * with bit j%64 of word j/64 of a row marking column j
+ * (the bits past column cols-1 in the last word are ignored).
+ * Rows are counted with a popcount per word, and columns
+ * by iterating over the set bits, on t threads
+ * (0 means one per hardware thread), each counting a chunk of the rows.
+ * Runtime complexity : O(rows*cols/64/t + n/t + cols), for n homes
+ */
+long long min_total_distance(const ::std::vector<::std::uint64_t> &bits,
+                             int rows, int cols, unsigned t = 0);
+
+/**
+ * Return floor(sqrt(n)), computed exactly in integer arithmetic
+ * by Newton's iteration x <- (x+n/x)/2 started above the root:
+ * the iterates decrease while they are larger than floor(sqrt(n)),
+ * so the first one that does not is the answer.
+ * Runtime complexity : O(loglogn) iterations
+ */
+::std::uint64_t isqrt(::std::uint64_t n);
+
 /**
  * There are n lockers in a hallway. 
  * A man begins by opening all 100 lockers.
@@ -26,21 +76,203 @@ int min_total_distance(const ::std::vector<::std::vector<int>> &grid);
  * the man toggles every ith locker.
  * Aften his nth pass in the hallway, in which he toggles
  * only locker number n, how many lockers are open?
- * Runtime complexity : O(sqrt(n))
+ * Runtime complexity : O(loglogn)
+ */
+long long n_lockers(long long n);
+
+/**
+ * Simulate the n passes of n_lockers over a bit-packed hallway,
+ * returning (n+64)/64 words with bit k%64 of word k/64 set
+ * iff locker k is open (bit 0 is always clear), which can be
+ * checked against n_lockers. Locker k is toggled once for each
+ * pair (i,q) with i*q = k: with s = isqrt(n), the pairs with i <= s
+ * are the passes i <= s, and the ones with i > s are the multiples
+ * of q > q*s, for q <= n/s, so that all the strides are at most
+ * about sqrt(n). The hallway is split into blocks that fit in the
+ * cache, toggled on t threads (0 means one per hardware thread):
+ * strides up to 64 by XOR-ing precomputed word masks, which repeat
+ * every stride words, and the larger ones bit by bit.
+ * Runtime complexity : O(nlogn/t) time, O(n/64) space
  */
-int n_lockers(int n);
+::std::vector<::std::uint64_t> simulate_lockers(::std::uint64_t n, unsigned t = 0);
+
+/**
+ * Return the carries of a+b, for an unsigned integer type T,
+ * where bit i is the carry into bit i (bit 0 being carry),
+ * computed without arithmetic operators by a Kogge-Stone parallel prefix:
+ * g (the bits generating a carry) and p (the bits propagating one)
+ * are combined over spans of 1,2,4,... bits, after which bit i of g
+ * tells whether the bits 0..i generate a carry. Every step is
+ * branchless, so that loops over arrays are vectorized by the compiler.
+ * Runtime complexity : O(log(bits))
+ */
+template <typename T>
+T carries_helper(T a, T b, bool carry = false) {
+  static_assert(::std::is_unsigned<T>::value, "carries_helper needs an unsigned type");
+  T g = a&b, p = a^b;
+  // the carry in, propagated by bit 0, is generated there
+  g |= p & T(carry);
+  for (unsigned d=1; d<8*sizeof(T); d<<=1) {
+    g |= p & (g << d);
+    p &= p << d;
+  }
+  return g << 1 | T(carry);
+}
 
 /**
  * Write a function that adds two n-bit numbers.
  * You should not use + or any other arithmetic operator.
- * Runtime complexity : O(n)
+ * Runtime complexity : O(logn)
  */
 int add_without_plus(int a, int b);
 
+/**
+ * Add the integers in [first1,last1) to the ones starting at first2,
+ * writing the sums (modulo 2^bits) starting at out, without arithmetic
+ * operators, with the carries of each pair computed as in carries_helper.
+ * Runtime complexity : O(nlog(bits))
+ */
+template <typename InputIt1, typename InputIt2, typename OutputIt>
+OutputIt add_without_plus(InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt out) {
+  using T = typename ::std::iterator_traits<InputIt1>::value_type;
+  using U = typename ::std::make_unsigned<T>::type;
+  for (; first1!=last1; ++first1, ++first2) {
+    U a = static_cast<U>(*first1), b = static_cast<U>(*first2);
+    *out++ = static_cast<T>(a ^ b ^ carries_helper(a, b));
+  }
+  return out;
+}
+
+/**
+ * Add the arbitrary width unsigned integers stored as little endian limbs
+ * in [first1,last1) and starting at first2, plus the carry in,
+ * writing the limbs of the sum starting at out, without arithmetic
+ * operators, and return the carry out. The carries within a limb are
+ * computed as in carries_helper, so that only one bit goes from a limb
+ * to the next one.
+ * Runtime complexity : O(nlog(bits)), for n limbs
+ */
+template <typename InputIt1, typename InputIt2, typename OutputIt>
+bool add_limbs(InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt out, bool carry = false) {
+  using T = typename ::std::iterator_traits<InputIt1>::value_type;
+  static_assert(::std::is_unsigned<T>::value, "add_limbs needs unsigned limbs");
+  const unsigned top = 8*sizeof(T)-1;
+  for (; first1!=last1; ++first1, ++first2) {
+    T a = *first1, b = *first2, c = carries_helper(a, b, carry);
+    *out++ = a ^ b ^ c;
+    // carry out of the top bit
+    carry = ((a & b) | ((a ^ b) & c)) >> top;
+  }
+  return carry;
+}
+
 /**
  * Write a method to count the number of 2s between 0 and n.
+ * See digit_counter for the other digits and bases.
+ * Runtime complexity : O(logn)
  */
-int number_of_twos(int n);
+long long number_of_twos(int n);
+
+/**
+ * Counter of the occurrences of a digit d in the base b representations
+ * of the integers in a range, for an unsigned integer type T
+ * (e.g. unsigned long long, or unsigned __int128), in which
+ * the counts are also computed.
+ * The counts over all the numbers with fewer digits than n are
+ * kept in per-length tables, built once, and the numbers with as many
+ * digits as n and not greater than n are counted by a digit DP over the
+ * digits of n: going from the most significant one, for every digit x
+ * smaller than n's at that position, the numbers with n's prefix, then x,
+ * then any k digits contain the prefix's and x's occurrences b^k times each,
+ * plus the k*b^(k-1) occurrences in all the strings of k digits.
+ * Counts are computed with the wrapping arithmetic of T, so that
+ * count(n) (count(lo,hi)) is exact if and only if the number of
+ * occurrences in 0..n (lo..hi) fits in T, and wraps silently otherwise.
+ * Every n up to max() is safe: for unsigned long long, 10^18-1 in base 10,
+ * and the whole unsigned long long range needs unsigned __int128.
+ * Runtime complexity : O(log_b(max(T))) construction, O(log_b(n)) per query
+ */
+template <typename T = unsigned long long>
+class digit_counter {
+public:
+  digit_counter(unsigned base, unsigned digit) : _b(base), _d(digit), _pow{1}, _full{0}, _shorter{0, 0} {
+    T max = ~T(0);
+    while (_pow.back() <= max/_b) {
+      ::std::size_t k = _pow.size();
+      _full.push_back(T(k)*_pow.back());
+      _pow.push_back(_pow.back()*_b);
+    }
+    // numbers of length 1, then of length l > 1 (no leading zeros)
+    _shorter.push_back(_d < _b);
+    for (::std::size_t l=2; l<_pow.size(); ++l) {
+      _shorter.push_back(_shorter.back() + (_d ? _pow[l-1] : 0) + T(_b-1)*_full[l-1]);
+    }
+    // the largest n of l digits such that (n+1)*l, at least
+    // the occurrences in 0..n, fits in T
+    for (::std::size_t l=1; l<=_pow.size(); ++l) {
+      T lower = l > 1 ? _pow[l-1] : 0, upper = l < _pow.size() ? _pow[l]-1 : max;
+      if (max/l == 0 || ::std::min(upper, max/l-1) < lower) break;
+      _max = ::std::min(upper, max/l-1);
+    }
+  }
+
+  /**
+   * Return the largest n whose counts are guaranteed to fit in T.
+   */
+  T max() const {
+    return _max;
+  }
+
+  /**
+   * Return the number of occurrences of the digit in 0,1,...,n.
+   */
+  T count(T n) const {
+    unsigned digits[8*sizeof(T)];
+    int l = 0;
+    do {
+      digits[l++] = n%_b;
+      n /= _b;
+    } while (n);
+    T total = _shorter[l], prefix = 0;
+    for (int i=l-1; i>=0; --i) {
+      unsigned lo = (i == l-1 && l > 1), x = digits[i];
+      if (x > lo) {
+        total += T(x-lo)*(prefix*_pow[i]+_full[i]);
+        if (lo <= _d && _d < x) total += _pow[i];
+      }
+      prefix += (x == _d);
+    }
+    return total+prefix;
+  }
+
+  /**
+   * Return the number of occurrences of the digit in lo,lo+1,...,hi.
+   */
+  T count(T lo, T hi) const {
+    if (hi < lo) return 0;
+    return lo ? count(hi)-count(lo-1) : count(hi);
+  }
+
+  /**
+   * Answer the [lo,hi] queries in [first,last), given as pairs,
+   * writing the counts starting at out.
+   */
+  template <typename InputIt, typename OutputIt>
+  void count_many(InputIt first, InputIt last, OutputIt out) const {
+    for (; first!=last; ++first) *out++ = count(first->first, first->second);
+  }
+
+private:
+  unsigned _b;
+  unsigned _d;
+  // _pow[k] = b^k
+  ::std::vector<T> _pow;
+  // _full[k] = occurrences of the digit in all the strings of k digits
+  ::std::vector<T> _full;
+  // _shorter[l] = occurrences of the digit in all the numbers with less than l digits
+  ::std::vector<T> _shorter;
+  T _max = 0;
+};
 
 } // math
 } // algorithms
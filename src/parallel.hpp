@@ -0,0 +1,51 @@
+#ifndef _PARALLEL_
+#define _PARALLEL_
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace algorithms {
+namespace parallel {
+
+/**
+ * Return the number of threads to use
+ * when t threads are requested (0 means one per hardware thread).
+ */
+inline unsigned threads(unsigned t) {
+  if (t) return t;
+  return ::std::max(1u, ::std::thread::hardware_concurrency());
+}
+
+/**
+ * Return the number of chunks for_chunks splits n items into,
+ * when t threads are requested and every chunk
+ * should have at least min_chunk items.
+ */
+inline ::std::size_t chunks(::std::size_t n, unsigned t, ::std::size_t min_chunk = 1) {
+  ::std::size_t c = ::std::max<::std::size_t>(1, n/::std::max<::std::size_t>(1, min_chunk));
+  return ::std::min<::std::size_t>(threads(t), c);
+}
+
+/**
+ * Split the index range [0,n) into chunks(n,t,min_chunk)
+ * contiguous chunks of almost equal size, and call
+ * f(c, begin, end) for each chunk c on its own thread.
+ * The last chunk is processed by the calling thread.
+ */
+template <typename F>
+void for_chunks(::std::size_t n, unsigned t, ::std::size_t min_chunk, F f) {
+  ::std::size_t c = chunks(n, t, min_chunk);
+  ::std::vector<::std::thread> workers;
+  workers.reserve(c-1);
+  for (::std::size_t i=0; i+1<c; ++i) {
+    workers.emplace_back([&f, i, c, n]() { f(i, n*i/c, n*(i+1)/c); });
+  }
+  f(c-1, n*(c-1)/c, n);
+  for (auto &w : workers) w.join();
+}
+
+} // parallel
+} // algorithms
+
+#endif
@@ -0,0 +1,254 @@
+#ifndef _PARTITION_
+#define _PARTITION_
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <type_traits>
+#include "parallel.hpp"
+
+namespace algorithms {
+namespace array {
+
+/**
+ * Partition the elements of the range [first,last)
+ * such that all elements satisfying predicate p
+ * are at the left of all other elements.
+ * Runtime complexity : O(n).
+ */
+template <typename RandomIt, typename P,
+          typename = ::std::enable_if_t<::std::is_invocable_r_v<bool, P&,
+            typename ::std::iterator_traits<RandomIt>::reference>>>
+void partition(RandomIt first, RandomIt last, P p) {
+  while (first != last) {
+    if (p(*first)) ++first;
+    else ::std::iter_swap(first, --last);
+  }
+}
+
+/**
+ * 3-way-partition the elements of the range [first,last)
+ * such that all elements are partitioned in 3 areas:
+ * less than pivot - equal to pivot - greater than pivot.
+ * Runtime complexity : O(n).
+ */
+template <typename RandomIt>
+void partition(RandomIt first, RandomIt last,
+               const typename ::std::iterator_traits<RandomIt>::value_type &pivot) {
+  auto i1 = first, i2 = first, i3 = last;
+  while (i2 != i3) {
+    if (*i2 == pivot) ++i2;
+    else if (*i2 < pivot) ::std::iter_swap(i1++, i2++);
+    else ::std::iter_swap(i2, --i3);
+  }
+}
+
+/**
+ * Partition the elements of an array
+ * such that all elements satisfying predicate p
+ * are at the left of all other elements.
+ * Runtime complexity : O(n).
+ */
+template <typename T, typename P>
+void partition(::std::vector<T> *vp, P p) {
+  ::algorithms::array::partition(vp->begin(), vp->end(), p);
+}
+
+/**
+ * 3-way-partition the elements of an array
+ * such that all elements are partitioned in 3 areas:
+ * less than pivot - equal to pivot - greater than pivot.
+ * Runtime complexity : O(n).
+ */
+template <typename T>
+void partition(::std::vector<T> *vp, const T &pivot) {
+  ::algorithms::array::partition(vp->begin(), vp->end(), pivot);
+}
+
+/**
+ * Branchless block partition of the range [first,last)
+ * (BlockQuicksort, Edelkamp and Weiss).
+ * Same result as partition, but instead of swapping
+ * on an unpredictable branch per element, a block of elements
+ * is scanned from each side, storing the offsets of the misplaced
+ * elements with a conditional increment, and the stored
+ * offsets are then swapped pairwise.
+ * Return an iterator to the first element not satisfying p,
+ * and set *swapped to whether any element was moved (only pairs
+ * of misplaced elements are swapped, so it is false exactly
+ * when the range was already partitioned).
+ * Runtime complexity : O(n).
+ */
+template <typename RandomIt, typename P,
+          typename = ::std::enable_if_t<::std::is_invocable_r_v<bool, P&,
+            typename ::std::iterator_traits<RandomIt>::reference>>>
+RandomIt partition_branchless(RandomIt first, RandomIt last, P p, bool *swapped) {
+  static const int kBlock = 64;
+  *swapped = false;
+  unsigned char offs_l[kBlock], offs_r[kBlock];
+  int num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+
+  /**
+   * Invariant: everything before first satisfies p,
+   * nothing from last onwards does, and offs_l (offs_r) holds the offsets
+   * of the misplaced elements of the block starting at first
+   * (ending at last) that are still to be swapped.
+   */
+  while (last-first > 2*kBlock) {
+    if (num_l == 0) {
+      start_l = 0;
+      for (int i=0; i<kBlock; ++i) {
+        offs_l[num_l] = i;
+        num_l += !p(first[i]);
+      }
+    }
+    if (num_r == 0) {
+      start_r = 0;
+      for (int i=0; i<kBlock; ++i) {
+        offs_r[num_r] = i;
+        num_r += !!p(*(last-1-i));
+      }
+    }
+    int num = ::std::min(num_l, num_r);
+    *swapped |= num > 0;
+    for (int k=0; k<num; ++k) {
+      ::std::iter_swap(first+offs_l[start_l+k], last-1-offs_r[start_r+k]);
+    }
+    num_l -= num; num_r -= num;
+    start_l += num; start_r += num;
+    if (num_l == 0) first += kBlock;
+    if (num_r == 0) last -= kBlock;
+  }
+
+  /**
+   * The half-processed block (if any) lies within [first,last).
+   * Only swap pairs of misplaced elements, so that the order
+   * of an already partitioned range is preserved.
+   */
+  while (true) {
+    while (first != last && p(*first)) ++first;
+    while (first != last && !p(*(last-1))) --last;
+    if (first == last) return first;
+    ::std::iter_swap(first++, --last);
+    *swapped = true;
+  }
+}
+
+template <typename RandomIt, typename P,
+          typename = ::std::enable_if_t<::std::is_invocable_r_v<bool, P&,
+            typename ::std::iterator_traits<RandomIt>::reference>>>
+RandomIt partition_branchless(RandomIt first, RandomIt last, P p) {
+  bool swapped;
+  return ::algorithms::array::partition_branchless(first, last, p, &swapped);
+}
+
+/**
+ * Branchless 3-way partition of the range [first,last)
+ * in the areas less than pivot - equal to pivot - greater than pivot,
+ * done as two passes of the branchless 2-way partition.
+ * Return the bounds of the area equal to pivot.
+ * Runtime complexity : O(n).
+ */
+template <typename RandomIt>
+::std::pair<RandomIt,RandomIt> partition_branchless(RandomIt first, RandomIt last,
+    const typename ::std::iterator_traits<RandomIt>::value_type &pivot) {
+  using value_type = typename ::std::iterator_traits<RandomIt>::value_type;
+  auto lt = ::algorithms::array::partition_branchless(first, last,
+      [&pivot](const value_type &x){return x < pivot;});
+  auto gt = ::algorithms::array::partition_branchless(lt, last,
+      [&pivot](const value_type &x){return !(pivot < x);});
+  return {lt, gt};
+}
+
+/**
+ * Stable partition of the range [first,last), using a scratch
+ * buffer of at least n elements starting at buffer.
+ * Every element is written both at the front (after the elements
+ * satisfying p seen so far) and at the back (before the
+ * other elements seen so far) of the buffer, and only the
+ * matching cursor is advanced, so that no branch is needed.
+ * The back of the buffer, which is in reverse order, is then
+ * copied back reversed.
+ * Return an iterator to the first element not satisfying p.
+ * Runtime complexity : O(n).
+ */
+template <typename RandomIt, typename RandomIt2, typename P>
+RandomIt stable_partition(RandomIt first, RandomIt last, RandomIt2 buffer, P p) {
+  using diff = typename ::std::iterator_traits<RandomIt>::difference_type;
+  diff n = last-first, lo = 0, hi = n-1;
+  for (auto it=first; it!=last; ++it) {
+    bool t = p(*it);
+    buffer[lo] = *it;
+    buffer[hi] = *it;
+    lo += t;
+    hi -= !t;
+  }
+  auto mid = ::std::copy(buffer, buffer+lo, first);
+  ::std::reverse_copy(buffer+lo, buffer+n, mid);
+  return mid;
+}
+
+/**
+ * Stable partition of a vector.
+ * Runtime complexity : O(n), O(n) additional space.
+ */
+template <typename T, typename P>
+typename ::std::vector<T>::iterator stable_partition(::std::vector<T> *vp, P p) {
+  ::std::vector<T> buffer(vp->size());
+  return ::algorithms::array::stable_partition(vp->begin(), vp->end(), buffer.begin(), p);
+}
+
+/**
+ * Minimum number of elements per thread in the parallel algorithms.
+ */
+static const ::std::size_t kParallelMinChunk = 1 << 16;
+
+/**
+ * Parallel stable partition of the range [first,last) on t threads
+ * (0 means one per hardware thread).
+ * The range is split in chunks; each thread counts the elements
+ * of its chunk satisfying p, the counts are prefix-summed to find
+ * where each chunk's elements go, then each thread scatters its chunk
+ * into a scratch buffer, which is finally copied back in parallel.
+ * Inputs smaller than a few chunks of kParallelMinChunk elements
+ * are processed on fewer threads.
+ * Return an iterator to the first element not satisfying p.
+ * Runtime complexity : O(n/t + t), O(n) additional space.
+ */
+template <typename RandomIt, typename P>
+RandomIt parallel_partition(RandomIt first, RandomIt last, P p, unsigned t = 0) {
+  using value_type = typename ::std::iterator_traits<RandomIt>::value_type;
+  ::std::size_t n = last-first;
+  ::std::size_t c = parallel::chunks(n, t, kParallelMinChunk);
+  ::std::vector<value_type> buffer(n);
+  ::std::vector<::std::size_t> trues(c+1), falses(c+1);
+
+  parallel::for_chunks(n, t, kParallelMinChunk, [&](::std::size_t i, ::std::size_t b, ::std::size_t e) {
+    ::std::size_t count = 0;
+    for (auto j=b; j<e; ++j) count += !!p(first[j]);
+    trues[i+1] = count;
+    falses[i+1] = e-b-count;
+  });
+  ::std::partial_sum(trues.begin(), trues.end(), trues.begin());
+  ::std::partial_sum(falses.begin(), falses.end(), falses.begin());
+
+  parallel::for_chunks(n, t, kParallelMinChunk, [&](::std::size_t i, ::std::size_t b, ::std::size_t e) {
+    ::std::size_t lo = trues[i], hi = trues[c]+falses[i];
+    for (auto j=b; j<e; ++j) {
+      bool x = p(first[j]);
+      buffer[x?lo:hi] = first[j];
+      lo += x;
+      hi += !x;
+    }
+  });
+  parallel::for_chunks(n, t, kParallelMinChunk, [&](::std::size_t, ::std::size_t b, ::std::size_t e) {
+    ::std::copy(buffer.begin()+b, buffer.begin()+e, first+b);
+  });
+  return first+trues[c];
+}
+
+} // array
+} // algorithms
+
+#endif
@@ -0,0 +1,334 @@
+#ifndef _PATTERNS_
+#define _PATTERNS_
+#include <vector>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include "bit.hpp"
+#include "sort.hpp"
+
+namespace algorithms {
+namespace array {
+
+/**
+ * Return the ranks of the elements of [first,last) in [0,m),
+ * in the order given by comp, with equivalent elements sharing a rank,
+ * and set *m to the number of distinct ranks.
+ * Runtime complexity : O(nlogn)
+ */
+template <typename RandomIt, typename Compare>
+::std::vector<int> ranks_helper(RandomIt first, RandomIt last, Compare comp, int *m) {
+  int n = last-first;
+  ::std::vector<int> idx(n), ranks(n);
+  ::std::iota(idx.begin(), idx.end(), 0);
+  ::algorithms::sort::pdqsort(idx.begin(), idx.end(), [&](int a, int b) {
+    return comp(first[a], first[b]);
+  });
+  *m = 0;
+  for (int i=0; i<n; ++i) {
+    if (i > 0 && comp(first[idx[i-1]], first[idx[i]])) ++*m;
+    ranks[idx[i]] = *m;
+  }
+  if (n) ++*m;
+  return ranks;
+}
+
+/**
+ * Return the number of subsequences of length k of [first,last)
+ * which are strictly increasing in the order given by comp.
+ * Counts are accumulated in type Count, which must be wide enough
+ * (e.g. __int128, or a modular integer type) for long sequences.
+ * For each length l, the number of increasing subsequences of length l
+ * ending at each element is the total of the ones of length l-1
+ * ending at a smaller element before it, which is a prefix query
+ * over the ranks on a Fenwick tree.
+ * Runtime complexity : O(k*nlogn)
+ */
+template <typename Count = long long, typename RandomIt, typename Compare = ::std::less<>>
+Count count_increasing_subsequences(RandomIt first, RandomIt last, int k, Compare comp = Compare()) {
+  if (k <= 0) return 0;
+  int m = 0, n = last-first;
+  auto ranks = ranks_helper(first, last, comp, &m);
+  ::std::vector<int> keys(m);
+  ::std::iota(keys.begin(), keys.end(), 0);
+  ::std::vector<Count> dp(n, Count(1)), next(n);
+  for (int l=2; l<=k; ++l) {
+    bit::bit<int,Count> tree(keys);
+    for (int i=0; i<n; ++i) {
+      next[i] = tree.countSmaller(ranks[i]);
+      tree.update(ranks[i], dp[i]);
+    }
+    dp.swap(next);
+  }
+  return ::std::accumulate(dp.begin(), dp.end(), Count(0));
+}
+
+/**
+ * Return the number of 132 patterns of [first,last), that is
+ * triplets i < j < k such that v[i] < v[k] < v[j],
+ * in the order given by comp (with ::std::greater<>, 312 patterns).
+ * Let R>(i) be the number of elements after i greater than v[i],
+ * and similarly for L<, R=: every pair of elements after i and
+ * greater than v[i] is a 123, a 132, or a 122 pattern (equal last two), so
+ *   #132 = sum_i R>(i)(R>(i)-1)/2 - #123 - #122
+ * with #123 = sum_j L<(j)R>(j) and #122 = sum_j L<(j)R=(j),
+ * and all the counts come from two passes over a Fenwick tree.
+ * Runtime complexity : O(nlogn)
+ */
+template <typename Count = long long, typename RandomIt, typename Compare = ::std::less<>>
+Count count_132_patterns(RandomIt first, RandomIt last, Compare comp = Compare()) {
+  int m = 0, n = last-first;
+  auto ranks = ranks_helper(first, last, comp, &m);
+  ::std::vector<int> keys(m);
+  ::std::iota(keys.begin(), keys.end(), 0);
+  ::std::vector<Count> greater_right(n), equal_right(n);
+  bit::bit<int,Count> right(keys);
+  for (int i=n-1; i>=0; --i) {
+    Count smaller = right.countSmaller(ranks[i]);
+    Count smaller_or_equal = right.countSmallerOrEqual(ranks[i]);
+    greater_right[i] = Count(n-1-i)-smaller_or_equal;
+    equal_right[i] = smaller_or_equal-smaller;
+    right.update(ranks[i]);
+  }
+  bit::bit<int,Count> left(keys);
+  Count count = 0;
+  for (int j=0; j<n; ++j) {
+    Count smaller_left = left.countSmaller(ranks[j]);
+    count += greater_right[j]*(greater_right[j]-1)/2;
+    count -= smaller_left*(greater_right[j]+equal_right[j]);
+    left.update(ranks[j]);
+  }
+  return count;
+}
+
+/**
+ * Return the number of 231 patterns of [first,last), that is
+ * triplets i < j < k such that v[k] < v[i] < v[j],
+ * in the order given by comp (with ::std::greater<>, 213 patterns):
+ * these are the 132 patterns of the reversed range.
+ * Runtime complexity : O(nlogn)
+ */
+template <typename Count = long long, typename RandomIt, typename Compare = ::std::less<>>
+Count count_231_patterns(RandomIt first, RandomIt last, Compare comp = Compare()) {
+  return count_132_patterns<Count>(::std::make_reverse_iterator(last),
+                                   ::std::make_reverse_iterator(first), comp);
+}
+
+/**
+ * Streaming detector of a strictly increasing subsequence of length k
+ * (in the order given by comp), which reads the elements
+ * one at a time, or a chunk at a time, and stops at the first one
+ * completing a subsequence of length k.
+ * For each length l, it keeps the increasing subsequence of length l
+ * with the smallest last element seen so far (patience sorting),
+ * whose last elements are increasing in l.
+ * Runtime complexity : O(logk) per element, plus O(k) per update
+ *                      of the kept subsequences; O(k^2) space
+ */
+template <typename T, typename Compare = ::std::less<>>
+class increasing_subsequence_detector {
+public:
+  explicit increasing_subsequence_detector(int k, Compare comp = Compare()) :
+    _k(::std::max(k,0)), _comp(comp), _chains(static_cast<::std::size_t>(_k)*_k), _n(0) {
+    _tails.reserve(_k);
+  };
+
+  /**
+   * Read x, and return whether a subsequence has been found.
+   */
+  bool push(const T &x) {
+    if (found()) return true;
+    long long i = _n++;
+    ::std::size_t l = ::std::lower_bound(_tails.begin(), _tails.end(), x, _comp)-_tails.begin();
+    if (l == _tails.size()) _tails.push_back(x);
+    else _tails[l] = x;
+    long long *chain = &_chains[l*_k];
+    if (l > 0) ::std::copy(chain-_k, chain-_k+l, chain);
+    chain[l] = i;
+    return found();
+  }
+
+  /**
+   * Read the elements of [first,last), stopping early at the first
+   * one which completes a subsequence, and return whether it was found.
+   */
+  template <typename InputIt>
+  bool push(InputIt first, InputIt last) {
+    for (; first!=last && !found(); ++first) push(*first);
+    return found();
+  }
+
+  bool found() const {
+    return static_cast<int>(_tails.size()) == _k;
+  }
+
+  /**
+   * Return the indices (in the stream) of the subsequence,
+   * or an empty vector if none was found yet.
+   */
+  ::std::vector<long long> witness() const {
+    if (!found() || _k == 0) return {};
+    return {_chains.end()-_k, _chains.end()};
+  }
+
+  long long size() const {
+    return _n;
+  }
+
+private:
+  int _k;
+  Compare _comp;
+  ::std::vector<T> _tails;
+  // _chains[l*k..l*k+l]: indices of the subsequence of length l+1
+  ::std::vector<long long> _chains;
+  long long _n;
+};
+
+/**
+ * Streaming detector of a 132 pattern (in the order given by comp;
+ * with ::std::greater<>, of a 312 pattern): the witness i < j < k
+ * has v[i] < v[k] < v[j].
+ * It keeps a stack of value intervals (v[i],v[j]) with i < j,
+ * v[i] <= v[j], whose lower ends decrease towards the top,
+ * and the intervals contained in a new one are dropped.
+ * A new element completes a pattern if it falls strictly
+ * inside one of the intervals.
+ * Runtime complexity : O(1) amortized per element
+ */
+template <typename T, typename Compare = ::std::less<>>
+class pattern_132_detector {
+public:
+  explicit pattern_132_detector(Compare comp = Compare()) :
+    _comp(comp), _n(0), _found(false), _witness{-1,-1,-1} {};
+
+  bool push(const T &x) {
+    if (_found) return true;
+    long long k = _n++;
+    if (_s.empty() || _comp(x, _s.back().lo)) {
+      _s.push_back({x, x, k, k});
+    }
+    else if (_comp(_s.back().lo, x)) {
+      interval last = _s.back();
+      _s.pop_back();
+      if (_comp(x, last.hi)) return found(last, k);
+      last.hi = x;
+      last.hi_idx = k;
+      while (!_s.empty() && !_comp(x, _s.back().hi)) _s.pop_back();
+      if (!_s.empty() && _comp(_s.back().lo, x)) return found(_s.back(), k);
+      _s.push_back(last);
+    }
+    return false;
+  }
+
+  template <typename InputIt>
+  bool push(InputIt first, InputIt last) {
+    for (; first!=last && !_found; ++first) push(*first);
+    return _found;
+  }
+
+  bool found() const {
+    return _found;
+  }
+
+  /**
+   * Return the indices (i,j,k) of the pattern, or (-1,-1,-1).
+   */
+  ::std::array<long long,3> witness() const {
+    return _witness;
+  }
+
+  long long size() const {
+    return _n;
+  }
+
+private:
+  struct interval {
+    T lo;
+    T hi;
+    long long lo_idx;
+    long long hi_idx;
+  };
+
+  bool found(const interval &in, long long k) {
+    _witness = {in.lo_idx, in.hi_idx, k};
+    return _found = true;
+  }
+
+  Compare _comp;
+  ::std::vector<interval> _s;
+  long long _n;
+  bool _found;
+  ::std::array<long long,3> _witness;
+};
+
+/**
+ * Streaming detector of a 231 pattern (in the order given by comp;
+ * with ::std::greater<>, of a 213 pattern): the witness i < j < k
+ * has v[k] < v[i] < v[j].
+ * It keeps a non-increasing stack of the elements with no greater
+ * element after them: when a greater element j arrives, they are popped,
+ * and the largest popped element i is the best candidate for the pair (i,j).
+ * Runtime complexity : O(1) amortized per element
+ */
+template <typename T, typename Compare = ::std::less<>>
+class pattern_231_detector {
+public:
+  explicit pattern_231_detector(Compare comp = Compare()) :
+    _comp(comp), _n(0), _pair{-1,-1}, _found(false), _witness{-1,-1,-1} {};
+
+  bool push(const T &x) {
+    if (_found) return true;
+    long long k = _n++;
+    if (_pair[0] >= 0 && _comp(x, _best)) {
+      _witness = {_pair[0], _pair[1], k};
+      return _found = true;
+    }
+    while (!_s.empty() && _comp(_s.back().first, x)) {
+      if (_pair[0] < 0 || _comp(_best, _s.back().first)) {
+        _best = _s.back().first;
+        _pair = {_s.back().second, k};
+      }
+      _s.pop_back();
+    }
+    _s.emplace_back(x, k);
+    return false;
+  }
+
+  template <typename InputIt>
+  bool push(InputIt first, InputIt last) {
+    for (; first!=last && !_found; ++first) push(*first);
+    return _found;
+  }
+
+  bool found() const {
+    return _found;
+  }
+
+  /**
+   * Return the indices (i,j,k) of the pattern, or (-1,-1,-1).
+   */
+  ::std::array<long long,3> witness() const {
+    return _witness;
+  }
+
+  long long size() const {
+    return _n;
+  }
+
+private:
+  Compare _comp;
+  ::std::vector<::std::pair<T,long long>> _s;
+  long long _n;
+  T _best;
+  ::std::array<long long,2> _pair;
+  bool _found;
+  ::std::array<long long,3> _witness;
+};
+
+} // array
+} // algorithms
+
+#endif
@@ -0,0 +1,390 @@
+#ifndef _PERMUTATION_
+#define _PERMUTATION_
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include "bit.hpp"
+#include "parallel.hpp"
+#include "partition.hpp"
+#include "patterns.hpp"
+
+namespace algorithms {
+namespace array {
+
+/**
+ * Bitmap of n bits, used to mark the visited elements
+ * when following the cycles of a permutation.
+ */
+class bitmap {
+public:
+  explicit bitmap(::std::size_t n) : _words((n+63)/64, 0) {};
+  bool test(::std::size_t i) const {
+    return (_words[i/64] >> (i%64)) & 1;
+  }
+  void set(::std::size_t i) {
+    _words[i/64] |= ::std::uint64_t(1) << (i%64);
+  }
+
+private:
+  ::std::vector<::std::uint64_t> _words;
+};
+
+/**
+ * Range overload of apply_permutation: p is the range [p_first,p_last)
+ * of n unique integers from 0 to n-1, where p[i] is the new index
+ * of v[i], and v is the range of the same length starting at v_first.
+ * Every cycle of p is rotated once, starting from its leader
+ * (its first element not yet visited), and the visited elements
+ * are marked on a bitmap (n bits), so p is left untouched.
+ * Runtime complexity : O(n)
+ */
+template <typename RandomIt1, typename RandomIt2>
+void apply_permutation(RandomIt1 p_first, RandomIt1 p_last, RandomIt2 v_first) {
+  ::std::size_t n = p_last-p_first;
+  bitmap visited(n);
+  for (::std::size_t i=0; i<n; ++i) {
+    if (visited.test(i)) continue;
+    auto cur = ::std::move(v_first[i]);
+    ::std::size_t j = i;
+    do {
+      visited.set(j);
+      j = p_first[j];
+      ::std::swap(cur, v_first[j]);
+    } while (j != i);
+  }
+}
+
+/**
+ * Out of place apply_permutation: write v[i], for v the range
+ * of n elements starting at v_first, to out[p[i]].
+ * Unlike the cycles followed in place, where every step has to wait
+ * for the index loaded by the previous one, the loads here are
+ * sequential and the writes independent, so that the processor
+ * can overlap their misses: for large n this is an order of magnitude
+ * faster than the in place version, when n more elements fit in memory.
+ * Runtime complexity : O(n)
+ */
+template <typename RandomIt1, typename RandomIt2, typename RandomIt3>
+void apply_permutation(RandomIt1 p_first, RandomIt1 p_last, RandomIt2 v_first, RandomIt3 out_first) {
+  ::std::size_t n = p_last-p_first;
+  for (::std::size_t i=0; i<n; ++i) out_first[p_first[i]] = v_first[i];
+}
+
+/**
+ * Parallel out of place apply_permutation, on t threads
+ * (0 means one per hardware thread): every thread scatters
+ * a contiguous chunk of v, and since p is a permutation
+ * no two threads write to the same destination.
+ * Runtime complexity : O(n/t)
+ */
+template <typename RandomIt1, typename RandomIt2, typename RandomIt3>
+void parallel_apply_permutation(RandomIt1 p_first, RandomIt1 p_last, RandomIt2 v_first,
+                                RandomIt3 out_first, unsigned t = 0) {
+  parallel::for_chunks(p_last-p_first, t, kParallelMinChunk, [&](::std::size_t, ::std::size_t b, ::std::size_t e) {
+    for (::std::size_t i=b; i<e; ++i) out_first[p_first[i]] = v_first[i];
+  });
+}
+
+/**
+ * Write the inverse of p, q such that q[p[i]] = i,
+ * starting at out_first, on t threads (0 means one per hardware thread).
+ * Runtime complexity : O(n/t)
+ */
+template <typename RandomIt1, typename RandomIt2>
+void inverse_permutation(RandomIt1 p_first, RandomIt1 p_last, RandomIt2 out_first, unsigned t = 0) {
+  using index_type = typename ::std::iterator_traits<RandomIt2>::value_type;
+  parallel::for_chunks(p_last-p_first, t, kParallelMinChunk, [&](::std::size_t, ::std::size_t b, ::std::size_t e) {
+    for (::std::size_t i=b; i<e; ++i) out_first[p_first[i]] = static_cast<index_type>(i);
+  });
+}
+
+/**
+ * Invert the permutation [first,last) in place:
+ * along every cycle i -> p[i] -> p[p[i]] -> ..., each
+ * element p[j] = k becomes p[k] = j. Visited elements
+ * are marked on a bitmap, as in apply_permutation.
+ * Runtime complexity : O(n)
+ */
+template <typename RandomIt>
+void invert_permutation(RandomIt first, RandomIt last) {
+  using index_type = typename ::std::iterator_traits<RandomIt>::value_type;
+  ::std::size_t n = last-first;
+  bitmap visited(n);
+  for (::std::size_t i=0; i<n; ++i) {
+    if (visited.test(i)) continue;
+    ::std::size_t j = i, k = first[i];
+    while (!visited.test(k)) {
+      visited.set(k);
+      ::std::size_t next = first[k];
+      first[k] = static_cast<index_type>(j);
+      j = k;
+      k = next;
+    }
+  }
+}
+
+/**
+ * Write the composition of p and q, the permutation r moving
+ * every element first as p then as q, that is r[i] = q[p[i]],
+ * starting at out_first, on t threads (0 means one per hardware thread).
+ * Runtime complexity : O(n/t)
+ */
+template <typename RandomIt1, typename RandomIt2, typename RandomIt3>
+void compose_permutations(RandomIt1 p_first, RandomIt1 p_last, RandomIt2 q_first,
+                          RandomIt3 out_first, unsigned t = 0) {
+  parallel::for_chunks(p_last-p_first, t, kParallelMinChunk, [&](::std::size_t, ::std::size_t b, ::std::size_t e) {
+    for (::std::size_t i=b; i<e; ++i) out_first[i] = q_first[p_first[i]];
+  });
+}
+
+/**
+ * Range overload of next_permutation: rearrange [first,last)
+ * into the next permutation in lexicographic order (repeated
+ * elements are allowed), and return true, or leave it unchanged
+ * and return false if it is the last one.
+ * The suffix after the pivot is non-increasing, so the element
+ * to swap with the pivot is found with a binary search.
+ * Runtime complexity : O(n)
+ */
+template <typename RandomIt>
+bool next_permutation(RandomIt first, RandomIt last) {
+  auto i = (last-first)-2;
+  while (i>=0 && !(first[i]<first[i+1])) --i;
+  if (i<0) return false;
+  auto it = ::std::upper_bound(::std::make_reverse_iterator(last), ::std::make_reverse_iterator(first+i+1), first[i]);
+  ::std::iter_swap(it,first+i);
+  ::std::reverse(first+i+1,last);
+  return true;
+}
+
+// the ranks of permutations of up to kMaxRankedPermutation elements fit in 64 bits
+static const int kMaxRankedPermutation = 20;
+
+inline unsigned long long factorial_helper(int n) {
+  unsigned long long f = 1;
+  for (int i=2; i<=n; ++i) f *= i;
+  return f;
+}
+
+/**
+ * Return the rank of the arrangement of the distinct elements of [first,last)
+ * among their permutations in lexicographic order, from 0.
+ * The rank is sum_i s(i)*(n-1-i)!, where s(i) is the number
+ * of elements after i smaller than it, counted on a Fenwick tree.
+ * n must be at most kMaxRankedPermutation.
+ * Runtime complexity : O(nlogn)
+ */
+template <typename RandomIt>
+unsigned long long permutation_rank(RandomIt first, RandomIt last) {
+  int m = 0, n = last-first;
+  auto ranks = ranks_helper(first, last, ::std::less<>(), &m);
+  ::std::vector<int> keys(n);
+  ::std::iota(keys.begin(), keys.end(), 0);
+  bit::bit<int> tree(keys);
+  unsigned long long rank = 0, f = 1;
+  for (int i=n-1; i>=0; --i) {
+    rank += tree.countSmaller(ranks[i])*f;
+    tree.update(ranks[i]);
+    f *= n-i;
+  }
+  return rank;
+}
+
+/**
+ * Rearrange the distinct elements of [first,last), given in increasing order,
+ * into their permutation of lexicographic rank r (taken modulo n!).
+ * The digits of r in the factorial number system select,
+ * from left to right, the rank of each element among the ones
+ * not used yet, which is found on a Fenwick tree.
+ * n must be at most kMaxRankedPermutation.
+ * Runtime complexity : O(nlogn)
+ */
+template <typename RandomIt>
+void permutation_unrank(unsigned long long r, RandomIt first, RandomIt last) {
+  using value_type = typename ::std::iterator_traits<RandomIt>::value_type;
+  int n = last-first;
+  ::std::vector<value_type> sorted(first, last);
+  ::std::vector<int> keys(n);
+  ::std::iota(keys.begin(), keys.end(), 0);
+  bit::bit<int> tree(keys);
+  for (int k : keys) tree.update(k);
+  unsigned long long f = factorial_helper(n);
+  r %= f;
+  for (int i=0; i<n; ++i) {
+    f /= n-i;
+    int idx = tree.select(static_cast<int>(r/f));
+    r %= f;
+    first[i] = ::std::move(sorted[idx]);
+    tree.update(idx, -1);
+  }
+}
+
+/**
+ * Split the ranks [0,n!) of the permutations of n elements
+ * into s contiguous ranges of almost equal size, for example
+ * to enumerate them on s threads (see permutation_generator).
+ * n must be at most kMaxRankedPermutation.
+ */
+inline ::std::vector<::std::pair<unsigned long long,unsigned long long>>
+permutation_shards(int n, unsigned s) {
+  unsigned long long total = factorial_helper(n);
+  s = ::std::max(1u, s);
+  ::std::vector<::std::pair<unsigned long long,unsigned long long>> shards;
+  unsigned long long q = total/s, rem = total%s, b = 0;
+  for (unsigned i=0; i<s; ++i) {
+    unsigned long long e = b+q+(i<rem);
+    shards.emplace_back(b, e);
+    b = e;
+  }
+  return shards;
+}
+
+/**
+ * Order in which permutation_generator enumerates permutations:
+ * - lexicographic: as next_permutation, O(1) amortized per step;
+ * - heap: Heap's algorithm, one swap per step (O(1) amortized);
+ * - plain_changes: Steinhaus-Johnson-Trotter order, as in Knuth's
+ *   algorithm P, one swap of adjacent elements per step (O(1) amortized).
+ */
+enum class permutation_order { lexicographic, heap, plain_changes };
+
+/**
+ * Generator of the permutations of a sequence of n elements,
+ * which copies them in batches into a caller buffer.
+ * In lexicographic order, the enumeration starts from the given
+ * arrangement and ends at the last one; in the other orders,
+ * it goes through all the n! arrangements (with repetitions
+ * if some elements are equal).
+ * A lexicographic generator can also be limited to a range of ranks
+ * (see permutation_shards), so that disjoint shards of the permutations
+ * of the same elements can be enumerated by different threads.
+ */
+template <typename T>
+class permutation_generator {
+public:
+  template <typename InputIt>
+  permutation_generator(InputIt first, InputIt last,
+                        permutation_order order = permutation_order::lexicographic) :
+    _a(first, last), _order(order), _left(::std::numeric_limits<unsigned long long>::max()),
+    _done(false), _i(1) {
+    ::std::size_t n = _a.size();
+    if (order == permutation_order::heap) _c.assign(n, 0);
+    if (order == permutation_order::plain_changes) {
+      _c.assign(n+1, 0);
+      _o.assign(n+1, 1);
+    }
+  }
+
+  /**
+   * Generator of the permutations of ranks [begin,end) in lexicographic
+   * order of the distinct elements of [first,last), given in increasing order.
+   */
+  template <typename InputIt>
+  permutation_generator(InputIt first, InputIt last,
+                        unsigned long long begin, unsigned long long end) :
+    permutation_generator(first, last) {
+    permutation_unrank(begin, _a.begin(), _a.end());
+    _left = end-begin;
+    _done = (end <= begin);
+  }
+
+  /**
+   * The current permutation, if not done().
+   */
+  const ::std::vector<T> &current() const {
+    return _a;
+  }
+
+  bool done() const {
+    return _done;
+  }
+
+  /**
+   * Move to the next permutation, and return false
+   * if there is none (the generator is then done()).
+   */
+  bool next() {
+    if (_done) return false;
+    if (--_left == 0 || !step()) _done = true;
+    return !_done;
+  }
+
+  /**
+   * Copy the current permutation and the following ones,
+   * up to m of them, to n*m elements starting at out,
+   * and move past them. Return the number of permutations copied.
+   */
+  template <typename OutputIt>
+  ::std::size_t next_batch(OutputIt out, ::std::size_t m) {
+    ::std::size_t k = 0;
+    for (; k<m && !_done; ++k) {
+      out = ::std::copy(_a.begin(), _a.end(), out);
+      next();
+    }
+    return k;
+  }
+
+private:
+  bool step() {
+    switch (_order) {
+    case permutation_order::heap:
+      return heap_step();
+    case permutation_order::plain_changes:
+      return plain_changes_step();
+    default:
+      return ::algorithms::array::next_permutation(_a.begin(), _a.end());
+    }
+  }
+
+  // Heap's algorithm: _c[i] counts the swaps done at level i
+  bool heap_step() {
+    ::std::size_t n = _a.size();
+    while (_i < n) {
+      if (_c[_i] < _i) {
+        ::std::swap(_a[_i%2 ? _c[_i] : 0], _a[_i]);
+        ++_c[_i];
+        _i = 1;
+        return true;
+      }
+      _c[_i++] = 0;
+    }
+    return false;
+  }
+
+  // Knuth's algorithm P: _c[j] (_o[j]) is the position (direction) of element j
+  bool plain_changes_step() {
+    long long s = 0;
+    for (long long j=_a.size(); j>=1; --j) {
+      long long c = _c[j], q = c+_o[j];
+      if (q == j) {
+        if (j == 1) return false;
+        ++s;
+      }
+      else if (q >= 0) {
+        ::std::swap(_a[j-c+s-1], _a[j-q+s-1]);
+        _c[j] = q;
+        return true;
+      }
+      _o[j] = -_o[j];
+    }
+    return false;
+  }
+
+  ::std::vector<T> _a;
+  permutation_order _order;
+  unsigned long long _left;
+  bool _done;
+  ::std::size_t _i;
+  ::std::vector<::std::size_t> _c;
+  ::std::vector<long long> _o;
+};
+
+} // array
+} // algorithms
+
+#endif
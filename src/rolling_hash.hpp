@@ -0,0 +1,203 @@
+#ifndef _ROLLING_HASH_
+#define _ROLLING_HASH_
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace algorithms {
+namespace string {
+
+// the Mersenne prime 2^61-1, modulus of the polynomial hashes
+const ::std::uint64_t kMersenne61 = (::std::uint64_t(1) << 61)-1;
+
+// reduce x < 2^64 modulo 2^61-1, using 2^61 = 1
+inline ::std::uint64_t mod_mersenne_helper(::std::uint64_t x) {
+  x = (x >> 61)+(x & kMersenne61);
+  return x >= kMersenne61 ? x-kMersenne61 : x;
+}
+
+// a*b modulo 2^61-1, for a,b < 2^61-1: the 122-bit product
+// is split at bit 61, whose two parts add up to less than 2(2^61-1)
+inline ::std::uint64_t mul_mod_helper(::std::uint64_t a, ::std::uint64_t b) {
+#if defined(__GNUC__) && defined(__SIZEOF_INT128__)
+  unsigned __int128 t = static_cast<unsigned __int128>(a)*b;
+  ::std::uint64_t r = static_cast<::std::uint64_t>(t >> 61)+(static_cast<::std::uint64_t>(t) & kMersenne61);
+  return r >= kMersenne61 ? r-kMersenne61 : r;
+#else
+  // a = au*2^31+ad, b = bu*2^31+bd, and 2^62 = 2
+  ::std::uint64_t au = a >> 31, ad = a & 0x7fffffff, bu = b >> 31, bd = b & 0x7fffffff;
+  ::std::uint64_t mid = ad*bu+au*bd;
+  return mod_mersenne_helper(2*au*bu+(mid >> 30)+((mid & 0x3fffffff) << 31)+ad*bd);
+#endif
+}
+
+/**
+ * Polynomial hash of strings modulo the Mersenne prime 2^61-1,
+ * with Hashes independent bases: the hash of c_0..c_{m-1}
+ * is the sum of (c_i+1)*B^(m-1-i) for every base B.
+ * Bases are drawn at random (unless given), so that two different
+ * strings of length m collide with probability at most m/2^61
+ * for every base, whatever the strings, and Hashes = 2 (double hashing)
+ * squares this probability.
+ * Runtime complexity : O(m) hash, O(logm) power, O(1) roll
+ */
+template <int Hashes = 1>
+class rolling_hash {
+public:
+  using value_type = ::std::array<::std::uint64_t, Hashes>;
+
+  rolling_hash() {
+    ::std::random_device rd;
+    ::std::seed_seq seed{
+      static_cast<::std::uint64_t>(rd()),
+      static_cast<::std::uint64_t>(::std::chrono::steady_clock::now().time_since_epoch().count())
+    };
+    ::std::mt19937_64 gen(seed);
+    ::std::uniform_int_distribution<::std::uint64_t> dist(1 << 9, kMersenne61-2);
+    for (auto &b : _bases) b = dist(gen);
+  }
+
+  explicit rolling_hash(const value_type &bases) : _bases(bases) {}
+
+  value_type hash(const char *first, const char *last) const {
+    value_type h{};
+    for (; first!=last; ++first) h = push(h, *first);
+    return h;
+  }
+
+  value_type hash(const ::std::string &s) const {
+    return hash(s.data(), s.data()+s.size());
+  }
+
+  /**
+   * Return the hash of the string of hash h followed by c.
+   */
+  value_type push(const value_type &h, char c) const {
+    value_type r;
+    for (int k=0; k<Hashes; ++k) r[k] = mod_mersenne_helper(mul_mod_helper(h[k], _bases[k])+value(c));
+    return r;
+  }
+
+  /**
+   * Return the hash of the window of m characters of hash h
+   * shifted by one, dropping out and appending in, given pw = power(m).
+   */
+  value_type roll(const value_type &h, char out, char in, const value_type &pw) const {
+    value_type r;
+    for (int k=0; k<Hashes; ++k) {
+      ::std::uint64_t drop = mul_mod_helper(value(out), pw[k]);
+      r[k] = mod_mersenne_helper(mul_mod_helper(h[k], _bases[k])+kMersenne61-drop+value(in));
+    }
+    return r;
+  }
+
+  /**
+   * Return the table of the value of every byte times pw, to roll
+   * windows with one modular multiplication per character.
+   */
+  ::std::vector<value_type> drops(const value_type &pw) const {
+    ::std::vector<value_type> result(kAlphabet);
+    for (int c=0; c<kAlphabet; ++c) {
+      for (int k=0; k<Hashes; ++k) result[c][k] = mul_mod_helper(c+1, pw[k]);
+    }
+    return result;
+  }
+
+  /**
+   * Roll as above, given the table dropped = drops(power(m)).
+   */
+  value_type roll(const value_type &h, char out, char in, const ::std::vector<value_type> &dropped) const {
+    const value_type &drop = dropped[static_cast<unsigned char>(out)];
+    value_type r;
+    for (int k=0; k<Hashes; ++k) {
+      r[k] = mod_mersenne_helper(mul_mod_helper(h[k], _bases[k])+kMersenne61-drop[k]+value(in));
+    }
+    return r;
+  }
+
+  /**
+   * Return the bases to the power n.
+   */
+  value_type power(::std::size_t n) const {
+    value_type r, b = _bases;
+    r.fill(1);
+    for (; n; n>>=1) {
+      for (int k=0; k<Hashes; ++k) {
+        if (n & 1) r[k] = mul_mod_helper(r[k], b[k]);
+        b[k] = mul_mod_helper(b[k], b[k]);
+      }
+    }
+    return r;
+  }
+
+  const value_type &bases() const {
+    return _bases;
+  }
+
+private:
+  static const int kAlphabet = 256;
+
+  static ::std::uint64_t value(char c) {
+    return static_cast<unsigned char>(c)+1;
+  }
+
+  value_type _bases;
+};
+
+/**
+ * Prefix hashes of a text t of n characters under a rolling_hash,
+ * with the powers of the bases, answering the hash of any substring
+ * as the difference of two prefix hashes: hash(t[0..p+m)) minus
+ * hash(t[0..p)) times B^m. Substrings of different tables built
+ * with the same rolling_hash are compared through their hashes.
+ * Runtime complexity : O(n) construction, O(1) per query
+ */
+template <int Hashes = 1>
+class prefix_hash {
+public:
+  using value_type = typename rolling_hash<Hashes>::value_type;
+
+  prefix_hash(const ::std::string &t, const rolling_hash<Hashes> &h) : _prefix(t.size()+1), _powers(t.size()+1) {
+    _powers[0].fill(1);
+    for (::std::size_t i=0; i<t.size(); ++i) {
+      _prefix[i+1] = h.push(_prefix[i], t[i]);
+      for (int k=0; k<Hashes; ++k) _powers[i+1][k] = mul_mod_helper(_powers[i][k], h.bases()[k]);
+    }
+  }
+
+  /**
+   * Return the hash of the m characters starting at p, for p+m <= n.
+   */
+  value_type substr(::std::size_t p, ::std::size_t m) const {
+    value_type r;
+    for (int k=0; k<Hashes; ++k) {
+      r[k] = mod_mersenne_helper(_prefix[p+m][k]+kMersenne61-mul_mod_helper(_prefix[p][k], _powers[m][k]));
+    }
+    return r;
+  }
+
+  /**
+   * Check if the m characters starting at p and at q are equal
+   * (with the collision probability of the rolling_hash).
+   */
+  bool equal(::std::size_t p, ::std::size_t q, ::std::size_t m) const {
+    return substr(p, m) == substr(q, m);
+  }
+
+  ::std::size_t size() const {
+    return _prefix.size()-1;
+  }
+
+private:
+  ::std::vector<value_type> _prefix;
+  ::std::vector<value_type> _powers;
+};
+
+} // string
+} // algorithms
+
+#endif
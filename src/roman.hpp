@@ -0,0 +1,148 @@
+#ifndef _ROMAN_
+#define _ROMAN_
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstring>
+
+namespace algorithms {
+namespace string {
+
+constexpr ::std::array<short,256> roman_values_helper() {
+  ::std::array<short,256> v{};
+  v['I'] = 1;
+  v['V'] = 5;
+  v['X'] = 10;
+  v['L'] = 50;
+  v['C'] = 100;
+  v['D'] = 500;
+  v['M'] = 1000;
+  return v;
+}
+
+// value of every byte as a Roman symbol, 0 if it is not one
+constexpr ::std::array<short,256> kRomanValues = roman_values_helper();
+
+// the longest numeral formatted by format_roman, MMMDCCCLXXXVIII (3888)
+const int kMaxRomanLength = 15;
+
+// parse the Roman symbols from *first up to last or to the first other
+// character, where *first is left, returning -1 if they are not valid
+inline int parse_roman_helper(const char **first, const char *last) {
+  const char *p = *first;
+  long long result = 0;
+  int bound = SHRT_MAX, prev = INT_MAX, v;
+  bool valid = true;
+  while (p != last && (v = kRomanValues[static_cast<unsigned char>(*p)])) {
+    ++p;
+    int w = p != last ? kRomanValues[static_cast<unsigned char>(*p)] : 0;
+    if (w > v) {
+      // only I, X and C precede the next two larger symbols, and only
+      // after a token of at least ten times their value (not VIV or LXL)
+      valid = (v == 1 || v == 10 || v == 100) && w <= 10*v && w-v <= bound && prev >= 10*v;
+      result += w-v;
+      bound = v-1;
+      prev = w-v;
+      ++p;
+    } else {
+      valid = v <= bound;
+      result += v;
+      bound = v;
+      prev = v;
+    }
+    if (!valid || result > INT_MAX) {
+      valid = false;
+      break;
+    }
+  }
+  valid = valid && p != *first && (p == last || !kRomanValues[static_cast<unsigned char>(*p)]);
+  *first = p;
+  return valid ? static_cast<int>(result) : -1;
+}
+
+/**
+ * Parse the Roman numeral [first,last) as in roman_to_integer,
+ * returning its value, or -1 if it is not valid or does not fit in an int.
+ * The numeral is read as a sequence of tokens, either a symbol
+ * or one of the exceptions IV, IX, XL, XC, CD and CM, whose values
+ * must not increase, and the symbol following an exception must be
+ * smaller than the exception's smaller symbol (so that IXC, IXI or XCX
+ * are not valid). An exception must also follow a token of at least ten
+ * times its smaller symbol, so that VIV, LXL or DCD are not valid.
+ * Repeated symbols are added up with no limit, so that the additive
+ * forms IIII, VV or XXXXX are accepted. Symbols are looked up in kRomanValues, with no branch
+ * on the character itself.
+ * Runtime complexity : O(n)
+ */
+inline int parse_roman(const char *first, const char *last) {
+  int result = parse_roman_helper(&first, last);
+  return first == last ? result : -1;
+}
+
+/**
+ * Write the standard (shortest) Roman numeral of n, from 1 to 3999,
+ * starting at out, which must have room for kMaxRomanLength characters,
+ * and return the end of the written numeral (nothing is written,
+ * and out is returned, if n is out of range). Every decimal digit
+ * of n is copied from a table of the numerals of the digits.
+ * Runtime complexity : O(1)
+ */
+inline char *format_roman(int n, char *out) {
+  static const char *const kDigits[4][10] = {
+    {"", "I", "II", "III", "IV", "V", "VI", "VII", "VIII", "IX"},
+    {"", "X", "XX", "XXX", "XL", "L", "LX", "LXX", "LXXX", "XC"},
+    {"", "C", "CC", "CCC", "CD", "D", "DC", "DCC", "DCCC", "CM"},
+    {"", "M", "MM", "MMM"}
+  };
+  static const unsigned char kLengths[10] = {0, 1, 2, 3, 2, 1, 2, 3, 4, 2};
+  if (n < 1 || n > 3999) return out;
+  int digits[4] = {n/1000, n/100%10, n/10%10, n%10};
+  for (int i=0; i<4; ++i) {
+    ::std::memcpy(out, kDigits[3-i][digits[i]], kLengths[digits[i]]);
+    out += kLengths[digits[i]];
+  }
+  return out;
+}
+
+/**
+ * Parse the newline separated Roman numerals in [first,last),
+ * writing their values (-1 for the invalid ones) starting at out,
+ * and return the end of the values. A final newline does not
+ * start another numeral. The lines are split while parsing them,
+ * in a single pass, and nothing is allocated.
+ * Runtime complexity : O(n), for n characters
+ */
+template <typename OutputIt>
+OutputIt parse_roman_lines(const char *first, const char *last, OutputIt out) {
+  while (first != last) {
+    int result = parse_roman_helper(&first, last);
+    if (first != last && *first != '\n') {
+      result = -1;
+      first = ::std::find(first, last, '\n');
+    }
+    *out++ = result;
+    if (first != last) ++first;
+  }
+  return out;
+}
+
+/**
+ * Write the Roman numerals of the integers in [first,last) starting
+ * at out, each followed by a newline (an empty line for the ones out
+ * of range), and return the end of the text. out must have room
+ * for kMaxRomanLength+1 characters per integer.
+ * Runtime complexity : O(n), for n integers
+ */
+template <typename InputIt>
+char *format_roman_lines(InputIt first, InputIt last, char *out) {
+  for (; first!=last; ++first) {
+    out = format_roman(*first, out);
+    *out++ = '\n';
+  }
+  return out;
+}
+
+} // string
+} // algorithms
+
+#endif
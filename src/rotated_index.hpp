@@ -0,0 +1,188 @@
+#ifndef _ROTATED_INDEX_
+#define _ROTATED_INDEX_
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+
+namespace algorithms {
+namespace array {
+
+/**
+ * Given a sorted array that has been rotated an unknown
+ * number of times, return an iterator to the first element
+ * of the original sorted array (the rotation point),
+ * so that [pivot,last) followed by [first,pivot) is sorted.
+ * When a[s] == a[m] == a[e], the halves can not be told apart,
+ * but if a[e] is not the rotation point (a[e-1] <= a[e]),
+ * e can be dropped from the search, so that duplicates
+ * only cost one step each.
+ * Runtime complexity : O(logn) (if unique elements)
+ *                      O(n) worst case (if repeated elements)
+ */
+template <typename RandomIt>
+RandomIt find_rotation(RandomIt first, RandomIt last) {
+  if (first == last) return first;
+  using diff = typename ::std::iterator_traits<RandomIt>::difference_type;
+  auto a = first;
+  diff s = 0, e = last-first-1;
+  while (s < e) {
+    diff m = s+(e-s)/2;
+    if (a[e] < a[m]) s = m+1;
+    else if (a[m] < a[e]) e = m;
+    else if (a[e] < a[e-1]) return first+e;
+    else --e;
+  }
+  return first+s;
+}
+
+/**
+ * Branchless lower bound of t in the sorted range [first,last):
+ * the range is halved at each step, and the comparison
+ * selects the half with a conditional move instead of a branch.
+ */
+template <typename RandomIt, typename T>
+RandomIt lower_bound_branchless(RandomIt first, RandomIt last, const T &t) {
+  auto n = last-first;
+  if (n == 0) return first;
+  while (n > 1) {
+    auto half = n/2;
+    first = (first[half-1] < t) ? first+half : first;
+    n -= half;
+  }
+  return first + (*first < t);
+}
+
+/**
+ * Search t in the rotated sorted range [first,last)
+ * whose rotation point pivot is known (see find_rotation).
+ * t can only be in [pivot,last) if it is not greater than
+ * the last element, and in [first,pivot) otherwise,
+ * and each run is searched with a branchless binary search.
+ * Return an iterator to an element equal to t, or last if t is not there.
+ * Runtime complexity : O(logn)
+ */
+template <typename RandomIt, typename T>
+RandomIt search_rotated(RandomIt first, RandomIt pivot, RandomIt last, const T &t) {
+  if (first == last) return last;
+  auto b = first, e = pivot;
+  if (!(*(last-1) < t)) b = pivot, e = last;
+  auto it = ::algorithms::array::lower_bound_branchless(b, e, t);
+  return (it != e && !(t < *it)) ? it : last;
+}
+
+/**
+ * Search index over a rotated sorted array, for repeated lookups.
+ * The rotation point is found once, at construction,
+ * and the elements are copied in Eytzinger order (the BFS order
+ * of the implicit binary search tree, as in a binary heap),
+ * so that the first levels of every search share the same few
+ * cache lines, and the descendants a few levels down are contiguous
+ * and can be prefetched while the current level is compared.
+ * Runtime complexity : O(n) construction (O(logn) rotation search)
+ *                      O(logn) per lookup
+ */
+template <typename T>
+class rotated_index {
+public:
+  template <typename RandomIt>
+  rotated_index(RandomIt first, RandomIt last) :
+    _n(last-first), _tree(_n+1), _idx(_n+1) {
+    _pivot = ::algorithms::array::find_rotation(first, last)-first;
+    ::std::size_t i = 0;
+    build(first, 1, i);
+  }
+
+  /**
+   * Return the rotation point of the indexed array.
+   */
+  ::std::ptrdiff_t pivot() const {
+    return _pivot;
+  }
+
+  /**
+   * Return the index in the original array of
+   * an element equal to t, or -1 if t is not there.
+   */
+  ::std::ptrdiff_t find(const T &t) const {
+    ::std::size_t k = 1;
+    while (k <= _n) {
+      prefetch(k);
+      k = 2*k + (_tree[k] < t);
+    }
+    return result(k, t);
+  }
+
+  /**
+   * Look up all the elements of [first,last), writing their
+   * indices (or -1) starting at out. Lookups are processed
+   * in groups of kBatch, advancing all of them one level at a time,
+   * so that the memory accesses of a group overlap.
+   */
+  template <typename InputIt, typename OutputIt>
+  void find_many(InputIt first, InputIt last, OutputIt out) const {
+    ::std::size_t levels = 0;
+    for (::std::size_t n=_n; n; n>>=1) ++levels;
+    T t[kBatch];
+    ::std::size_t k[kBatch];
+    while (first != last) {
+      int m = 0;
+      for (; m<kBatch && first!=last; ++m, ++first) {
+        t[m] = *first;
+        k[m] = 1;
+      }
+      for (::std::size_t l=0; l<levels; ++l) {
+        for (int j=0; j<m; ++j) {
+          if (k[j] <= _n) {
+            prefetch(k[j]);
+            k[j] = 2*k[j] + (_tree[k[j]] < t[j]);
+          }
+        }
+      }
+      for (int j=0; j<m; ++j) *out++ = result(k[j], t[j]);
+    }
+  }
+
+private:
+  static const int kBatch = 16;
+
+  // fill the subtree rooted at k with the elements of the sorted order from i
+  template <typename RandomIt>
+  void build(RandomIt first, ::std::size_t k, ::std::size_t &i) {
+    if (k > _n) return;
+    build(first, 2*k, i);
+    ::std::size_t j = (i++ + static_cast<::std::size_t>(_pivot)) % _n;
+    _tree[k] = first[j];
+    _idx[k] = j;
+    build(first, 2*k+1, i);
+  }
+
+  // the descendants of k four levels down are 16 contiguous elements from 16*k
+  void prefetch(::std::size_t k) const {
+#if defined(__GNUC__)
+    if (16*k <= _n) __builtin_prefetch(&_tree[16*k]);
+#endif
+  }
+
+  /**
+   * The search went right (t greater) at each level
+   * after the one where it last went left: undoing those
+   * right turns, plus the last left one, gives the lower bound.
+   */
+  ::std::ptrdiff_t result(::std::size_t k, const T &t) const {
+    while (k & 1) k >>= 1;
+    k >>= 1;
+    if (k == 0 || t < _tree[k]) return -1;
+    return _idx[k];
+  }
+
+  ::std::size_t _n;
+  ::std::ptrdiff_t _pivot;
+  ::std::vector<T> _tree;
+  ::std::vector<::std::size_t> _idx;
+};
+
+} // array
+} // algorithms
+
+#endif
@@ -0,0 +1,338 @@
+#ifndef _SLIDING_WINDOW_
+#define _SLIDING_WINDOW_
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+namespace algorithms {
+namespace array {
+
+/**
+ * Multiset of elements of type T, kept as a map from element to count
+ * in an open-addressed table with robin hood hashing:
+ * an element being inserted takes the slot of any element
+ * closer than it to its home slot, which keeps probe sequences short,
+ * lets lookups stop as soon as they meet an element closer to its home,
+ * and lets removals shift the following elements back instead of
+ * leaving tombstones. Hashes are spread over the table with
+ * Fibonacci hashing, so that regular keys (e.g. multiples of
+ * a power of two) do not collide.
+ * Runtime complexity : O(1) expected per operation
+ */
+template <typename T, typename Hash = ::std::hash<T>>
+class robin_hood_counter {
+public:
+  explicit robin_hood_counter(::std::size_t capacity = 16) : _size(0) {
+    _shift = 64;
+    ::std::size_t c = 1;
+    while (c < 2*capacity) c <<= 1, --_shift;
+    _slots.resize(c);
+  }
+
+  /**
+   * Add one occurrence of x, and return its count.
+   */
+  long long add(const T &x) {
+    ::std::size_t i = find(x);
+    if (i != kNone) return ++_slots[i].count;
+    if (4*(_size+1) > 3*_slots.size()) grow();
+    insert({x, 1, 0});
+    ++_size;
+    return 1;
+  }
+
+  /**
+   * Remove one occurrence of x, which must be there, and return its count.
+   */
+  long long remove(const T &x) {
+    ::std::size_t i = find(x);
+    long long c = --_slots[i].count;
+    if (c == 0) {
+      // backward shift deletion
+      ::std::size_t mask = _slots.size()-1;
+      for (::std::size_t j=(i+1)&mask; _slots[j].count && _slots[j].dist; i=j, j=(j+1)&mask) {
+        _slots[i] = ::std::move(_slots[j]);
+        --_slots[i].dist;
+      }
+      _slots[i].count = 0;
+      --_size;
+    }
+    return c;
+  }
+
+  /**
+   * Return the number of occurrences of x.
+   */
+  long long count(const T &x) const {
+    ::std::size_t i = find(x);
+    return i == kNone ? 0 : _slots[i].count;
+  }
+
+  /**
+   * Return the number of distinct elements.
+   */
+  ::std::size_t distinct() const {
+    return _size;
+  }
+
+  void clear() {
+    for (auto &s : _slots) s.count = 0;
+    _size = 0;
+  }
+
+private:
+  static const ::std::size_t kNone = static_cast<::std::size_t>(-1);
+
+  struct slot {
+    T key;
+    long long count; // 0 if the slot is empty
+    ::std::size_t dist; // distance from the home slot
+  };
+
+  ::std::size_t home(const T &x) const {
+    ::std::uint64_t h = static_cast<::std::uint64_t>(_hash(x))*0x9E3779B97F4A7C15ULL;
+    return _shift == 64 ? 0 : static_cast<::std::size_t>(h >> _shift);
+  }
+
+  ::std::size_t find(const T &x) const {
+    ::std::size_t mask = _slots.size()-1;
+    ::std::size_t i = home(x);
+    for (::std::size_t d=0; _slots[i].count && _slots[i].dist >= d; ++d, i=(i+1)&mask) {
+      if (_slots[i].key == x) return i;
+    }
+    return kNone;
+  }
+
+  void insert(slot s) {
+    ::std::size_t mask = _slots.size()-1;
+    for (::std::size_t i=home(s.key); ; i=(i+1)&mask, ++s.dist) {
+      if (!_slots[i].count) {
+        _slots[i] = ::std::move(s);
+        return;
+      }
+      if (_slots[i].dist < s.dist) ::std::swap(_slots[i], s);
+    }
+  }
+
+  void grow() {
+    ::std::vector<slot> old(2*_slots.size());
+    old.swap(_slots);
+    --_shift;
+    for (auto &s : old) {
+      if (s.count) {
+        s.dist = 0;
+        insert(::std::move(s));
+      }
+    }
+  }
+
+  ::std::vector<slot> _slots;
+  ::std::size_t _size;
+  int _shift;
+  Hash _hash;
+};
+
+/**
+ * Multiset of integers in [0,domain), kept as a flat array of counts,
+ * with the same interface as robin_hood_counter.
+ * Runtime complexity : O(1) per operation, O(domain) space
+ */
+class flat_counter {
+public:
+  explicit flat_counter(::std::size_t domain) : _counts(domain, 0), _size(0) {};
+
+  long long add(::std::size_t x) {
+    long long c = ++_counts[x];
+    _size += (c == 1);
+    return c;
+  }
+
+  long long remove(::std::size_t x) {
+    long long c = --_counts[x];
+    _size -= (c == 0);
+    return c;
+  }
+
+  long long count(::std::size_t x) const {
+    return _counts[x];
+  }
+
+  ::std::size_t distinct() const {
+    return _size;
+  }
+
+  void clear() {
+    ::std::fill(_counts.begin(), _counts.end(), 0);
+    _size = 0;
+  }
+
+private:
+  ::std::vector<long long> _counts;
+  ::std::size_t _size;
+};
+
+/**
+ * Window over a stream of elements, with elements pushed
+ * at the back and popped from the front, which keeps
+ * the number of distinct elements it contains.
+ * Runtime complexity : O(1) expected per operation
+ */
+template <typename T, typename Counter = robin_hood_counter<T>>
+class distinct_window {
+public:
+  explicit distinct_window(Counter counter = Counter()) : _counter(::std::move(counter)) {};
+
+  void push(const T &x) {
+    _window.push_back(x);
+    _counter.add(x);
+  }
+
+  void pop() {
+    _counter.remove(_window.front());
+    _window.pop_front();
+  }
+
+  const T &front() const {
+    return _window.front();
+  }
+
+  ::std::size_t distinct() const {
+    return _counter.distinct();
+  }
+
+  ::std::size_t size() const {
+    return _window.size();
+  }
+
+private:
+  ::std::deque<T> _window;
+  Counter _counter;
+};
+
+/**
+ * Over a stream of elements, maintain the longest window
+ * with at most k distinct elements, and the number of windows
+ * (subarrays) with exactly k distinct elements, seen so far.
+ * Two windows ending at the last element are kept:
+ * the longest one with at most k distinct elements,
+ * and the longest one with at most k-1, which is a suffix of it;
+ * the windows ending at the last element with exactly k distinct
+ * elements are the ones starting in the first and not in the second.
+ * Runtime complexity : O(1) amortized expected per element
+ */
+template <typename T, typename Counter = robin_hood_counter<T>>
+class k_distinct_stream {
+public:
+  explicit k_distinct_stream(int k, Counter counter = Counter()) :
+    _k(k), _outer(counter), _inner(::std::move(counter)),
+    _inner_begin(0), _longest(0), _exactly_k(0) {};
+
+  void push(const T &x) {
+    if (_k <= 0) return;
+    _window.push_back(x);
+    _outer.add(x);
+    _inner.add(x);
+    while (_inner.distinct() > static_cast<::std::size_t>(_k-1)) _inner.remove(_window[_inner_begin++]);
+    while (_outer.distinct() > static_cast<::std::size_t>(_k)) {
+      _outer.remove(_window.front());
+      _window.pop_front();
+      --_inner_begin;
+    }
+    _longest = ::std::max(_longest, _window.size());
+    _exactly_k += _inner_begin;
+  }
+
+  /**
+   * Length of the longest window with at most k distinct elements.
+   */
+  ::std::size_t longest() const {
+    return _longest;
+  }
+
+  /**
+   * Number of windows with exactly k distinct elements.
+   */
+  long long exactly_k() const {
+    return _exactly_k;
+  }
+
+  /**
+   * Length of the longest window with at most k distinct elements
+   * ending at the last element.
+   */
+  ::std::size_t size() const {
+    return _window.size();
+  }
+
+private:
+  int _k;
+  ::std::deque<T> _window;
+  Counter _outer;
+  Counter _inner;
+  ::std::size_t _inner_begin;
+  ::std::size_t _longest;
+  long long _exactly_k;
+};
+
+/**
+ * Return the length of the longest subarray of [first,last)
+ * with at most k distinct elements.
+ * Runtime complexity : O(n) expected
+ */
+template <typename ForwardIt,
+          typename Counter = robin_hood_counter<typename ::std::iterator_traits<ForwardIt>::value_type>>
+::std::size_t longest_at_most_k_distinct(ForwardIt first, ForwardIt last, int k,
+                                         Counter counter = Counter()) {
+  if (k <= 0) return 0;
+  ::std::size_t longest = 0, size = 0;
+  for (auto it=first; it!=last; ++it) {
+    counter.add(*it);
+    ++size;
+    while (counter.distinct() > static_cast<::std::size_t>(k)) {
+      counter.remove(*first++);
+      --size;
+    }
+    longest = ::std::max(longest, size);
+  }
+  return longest;
+}
+
+/**
+ * Return the number of subarrays of [first,last)
+ * with exactly k distinct elements.
+ * Runtime complexity : O(n) expected
+ */
+template <typename ForwardIt,
+          typename Counter = robin_hood_counter<typename ::std::iterator_traits<ForwardIt>::value_type>>
+long long count_exactly_k_distinct(ForwardIt first, ForwardIt last, int k,
+                                   Counter counter = Counter()) {
+  if (k <= 0) return 0;
+  // outer (inner) starts the longest window with at most k (k-1) distinct elements
+  Counter inner = counter;
+  auto outer_first = first, inner_first = first;
+  long long count = 0, gap = 0;
+  for (auto it=first; it!=last; ++it) {
+    counter.add(*it);
+    inner.add(*it);
+    while (inner.distinct() > static_cast<::std::size_t>(k-1)) {
+      inner.remove(*inner_first++);
+      ++gap;
+    }
+    while (counter.distinct() > static_cast<::std::size_t>(k)) {
+      counter.remove(*outer_first++);
+      --gap;
+    }
+    count += gap;
+  }
+  return count;
+}
+
+} // array
+} // algorithms
+
+#endif
@@ -0,0 +1,507 @@
+#ifndef _SORT_
+#define _SORT_
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include "partition.hpp"
+#include "parallel.hpp"
+
+namespace algorithms {
+namespace sort {
+
+/**
+ * Sort the range [first,last) with insertion sort.
+ * Runtime complexity : O(n2), O(n+k) for k inversions.
+ */
+template <typename RandomIt, typename Compare>
+void insertion_sort(RandomIt first, RandomIt last, Compare comp) {
+  if (first == last) return;
+  for (auto i=first+1; i!=last; ++i) {
+    auto x = ::std::move(*i);
+    auto j = i;
+    for (; j!=first && comp(x, *(j-1)); --j) *j = ::std::move(*(j-1));
+    *j = ::std::move(x);
+  }
+}
+
+/**
+ * Maximum size of the ranges sorted by sort_network.
+ */
+static const int kNetworkSize = 16;
+
+/**
+ * Sort a range of at most kNetworkSize arithmetic values
+ * with Batcher's odd-even merge sorting network.
+ * The range is padded to kNetworkSize elements with the largest value
+ * (+infinity for floating-point types, so that an infinity of the range
+ * is kept), and every comparator is a branchless min/max pair,
+ * so that the sequence of operations does not depend on the data
+ * and the compiler can vectorize the independent comparators.
+ * Runtime complexity : O(1) (about 63 comparators).
+ */
+template <typename RandomIt>
+void sort_network(RandomIt first, RandomIt last) {
+  using value_type = typename ::std::iterator_traits<RandomIt>::value_type;
+  static_assert(::std::is_arithmetic_v<value_type>, "sort_network needs arithmetic values");
+  const int n = last-first;
+  value_type a[kNetworkSize];
+  ::std::copy(first, last, a);
+  using limits = ::std::numeric_limits<value_type>;
+  ::std::fill(a+n, a+kNetworkSize, limits::has_infinity ? limits::infinity() : limits::max());
+  for (int p=1; p<kNetworkSize; p<<=1) {
+    for (int k=p; k>=1; k>>=1) {
+      for (int j=k%p; j+k<kNetworkSize; j+=2*k) {
+        for (int i=0; i<k && i+j+k<kNetworkSize; ++i) {
+          if ((i+j)/(2*p) == (i+j+k)/(2*p)) {
+            value_type lo = ::std::min(a[i+j], a[i+j+k]);
+            value_type hi = ::std::max(a[i+j], a[i+j+k]);
+            a[i+j] = lo;
+            a[i+j+k] = hi;
+          }
+        }
+      }
+    }
+  }
+  ::std::copy(a, a+n, first);
+}
+
+/**
+ * Sort 3 elements, so that the median ends up in b.
+ */
+template <typename RandomIt, typename Compare>
+void sort3(RandomIt a, RandomIt b, RandomIt c, Compare comp) {
+  if (comp(*b, *a)) ::std::iter_swap(a, b);
+  if (comp(*c, *b)) ::std::iter_swap(b, c);
+  if (comp(*b, *a)) ::std::iter_swap(a, b);
+}
+
+static const int kPartialInsertionLimit = 8;
+
+/**
+ * Attempt to sort [first,last) with insertion sort,
+ * giving up (and returning false) as soon as
+ * more than kPartialInsertionLimit elements have been moved.
+ */
+template <typename RandomIt, typename Compare>
+bool partial_insertion_sort(RandomIt first, RandomIt last, Compare comp) {
+  if (first == last) return true;
+  int moved = 0;
+  for (auto i=first+1; i!=last; ++i) {
+    if (!comp(*i, *(i-1))) continue;
+    auto x = ::std::move(*i);
+    auto j = i;
+    for (; j!=first && comp(x, *(j-1)); --j) *j = ::std::move(*(j-1));
+    *j = ::std::move(x);
+    moved += i-j;
+    if (moved > kPartialInsertionLimit) return false;
+  }
+  return true;
+}
+
+static const int kInsertionSortThreshold = 24;
+static const int kNintherThreshold = 128;
+
+/**
+ * Whether the small ranges of a pdqsort can be delegated to sort_network:
+ * only for integers, as a min/max pair may duplicate or drop a NaN.
+ */
+template <typename T, typename Compare>
+constexpr bool uses_sort_network =
+  ::std::is_integral_v<T> &&
+  (::std::is_same_v<Compare, ::std::less<>> || ::std::is_same_v<Compare, ::std::less<T>>);
+
+template <typename RandomIt, typename Compare>
+void pdqsort_helper(RandomIt first, RandomIt last, Compare comp, int bad_allowed, bool leftmost) {
+  using value_type = typename ::std::iterator_traits<RandomIt>::value_type;
+  while (true) {
+    auto n = last-first;
+    if constexpr (uses_sort_network<value_type, Compare>) {
+      if (n <= kNetworkSize) {
+        ::algorithms::sort::sort_network(first, last);
+        return;
+      }
+    }
+    if (n < kInsertionSortThreshold) {
+      ::algorithms::sort::insertion_sort(first, last, comp);
+      return;
+    }
+
+    // move the pivot, a median of 3 or a pseudo-median of 9, to first
+    auto s2 = n/2;
+    if (n > kNintherThreshold) {
+      sort3(first, first+s2, last-1, comp);
+      sort3(first+1, first+(s2-1), last-2, comp);
+      sort3(first+2, first+(s2+1), last-3, comp);
+      sort3(first+(s2-1), first+s2, first+(s2+1), comp);
+      ::std::iter_swap(first, first+s2);
+    }
+    else sort3(first+s2, first, last-1, comp);
+
+    /**
+     * If the pivot equals the element just before the range
+     * (the pivot of an ancestor call, which is not greater than anything
+     * in the range), all the elements equal to it are moved to the left
+     * and skipped, so that many equal keys take linear time.
+     */
+    if (!leftmost && !comp(*(first-1), *first)) {
+      const value_type &pivot = *first;
+      first = ::algorithms::array::partition_branchless(first+1, last,
+          [&](const value_type &x){return !comp(pivot, x);});
+      continue;
+    }
+
+    value_type pivot = ::std::move(*first);
+    bool swapped;
+    auto mid = ::algorithms::array::partition_branchless(first+1, last,
+        [&](const value_type &x){return comp(x, pivot);}, &swapped);
+    auto pivot_pos = mid-1;
+    *first = ::std::move(*pivot_pos);
+    *pivot_pos = ::std::move(pivot);
+
+    auto l_size = pivot_pos-first, r_size = last-(pivot_pos+1);
+    if (l_size < n/8 || r_size < n/8) {
+      // unbalanced partition: shuffle some elements to break the pattern
+      if (--bad_allowed == 0) {
+        ::std::make_heap(first, last, comp);
+        ::std::sort_heap(first, last, comp);
+        return;
+      }
+      if (l_size >= kInsertionSortThreshold) {
+        ::std::iter_swap(first, first+l_size/4);
+        ::std::iter_swap(pivot_pos-1, pivot_pos-l_size/4);
+      }
+      if (r_size >= kInsertionSortThreshold) {
+        ::std::iter_swap(pivot_pos+1, pivot_pos+1+r_size/4);
+        ::std::iter_swap(last-1, last-r_size/4);
+      }
+    }
+    else if (!swapped &&
+             ::algorithms::sort::partial_insertion_sort(first, pivot_pos, comp) &&
+             ::algorithms::sort::partial_insertion_sort(pivot_pos+1, last, comp)) {
+      // balanced partition which moved nothing: the data may be (nearly) sorted
+      return;
+    }
+
+    pdqsort_helper(first, pivot_pos, comp, bad_allowed, leftmost);
+    first = pivot_pos+1;
+    leftmost = false;
+  }
+}
+
+/**
+ * Sort the range [first,last) with pattern-defeating quicksort
+ * (Orson Peters): a quicksort using the branchless block partition,
+ * which takes linear time on sorted and equal-key inputs,
+ * breaks up the patterns causing unbalanced partitions, falls back to heapsort after too many
+ * unbalanced partitions, and sorts small ranges with insertion sort
+ * (or with a sorting network, for arithmetic types).
+ * The sort is not stable.
+ * Runtime complexity : O(nlogn) worst case, O(n) on sorted and equal-key input
+ */
+template <typename RandomIt, typename Compare>
+void pdqsort(RandomIt first, RandomIt last, Compare comp) {
+  auto n = last-first;
+  int log2 = 0;
+  while (n >>= 1) ++log2;
+  pdqsort_helper(first, last, comp, log2+1, true);
+}
+
+template <typename RandomIt>
+void pdqsort(RandomIt first, RandomIt last) {
+  ::algorithms::sort::pdqsort(first, last, ::std::less<>());
+}
+
+/**
+ * Map an integer (or a pair of integers of at most 32 bits)
+ * to an unsigned key with the same ordering,
+ * by flipping the sign bit of signed values.
+ */
+template <typename T>
+typename ::std::enable_if_t<::std::is_integral_v<T>, ::std::make_unsigned<T>>::type radix_key(T x) {
+  using U = ::std::make_unsigned_t<T>;
+  U u = static_cast<U>(x);
+  if constexpr (::std::is_signed_v<T>) u ^= U(1) << (8*sizeof(T)-1);
+  return u;
+}
+
+template <typename T1, typename T2>
+::std::uint64_t radix_key(const ::std::pair<T1,T2> &p) {
+  static_assert(sizeof(T1) <= 4 && sizeof(T2) <= 4, "radix_key needs pairs of 32-bit integers");
+  return (static_cast<::std::uint64_t>(radix_key(p.first)) << 32) | radix_key(p.second);
+}
+
+/**
+ * Stable LSD radix sort of the range [first,last) by key(x),
+ * which must be an unsigned integer, using one pass per byte of the key
+ * and a scratch buffer of at least n elements starting at buffer.
+ * The histograms of all passes are computed in a single read of the input,
+ * and passes where all elements share the same byte are skipped.
+ * Runtime complexity : O(n*w), where w is the size of the key in bytes
+ */
+template <typename RandomIt, typename RandomIt2, typename Key>
+void radix_sort(RandomIt first, RandomIt last, RandomIt2 buffer, Key key) {
+  using key_type = decltype(key(*first));
+  static_assert(::std::is_unsigned_v<key_type>, "radix_sort needs unsigned keys");
+  static const int kPasses = sizeof(key_type);
+  ::std::size_t n = last-first;
+  ::std::array<::std::array<::std::size_t,256>,kPasses> counts{};
+  for (auto it=first; it!=last; ++it) {
+    key_type k = key(*it);
+    for (int p=0; p<kPasses; ++p) ++counts[p][(k >> (8*p)) & 0xff];
+  }
+
+  bool in_buffer = false;
+  auto scatter = [&](auto src, auto dst, int p) {
+    ::std::array<::std::size_t,256> offsets;
+    ::std::size_t sum = 0;
+    for (int d=0; d<256; ++d) {
+      offsets[d] = sum;
+      sum += counts[p][d];
+    }
+    for (::std::size_t i=0; i<n; ++i) {
+      dst[offsets[(key(src[i]) >> (8*p)) & 0xff]++] = ::std::move(src[i]);
+    }
+  };
+  for (int p=0; p<kPasses; ++p) {
+    if (::std::find(counts[p].begin(), counts[p].end(), n) != counts[p].end()) continue;
+    if (in_buffer) scatter(buffer, first, p);
+    else scatter(first, buffer, p);
+    in_buffer = !in_buffer;
+  }
+  if (in_buffer) ::std::move(buffer, buffer+n, first);
+}
+
+/**
+ * Stable LSD radix sort of a range of integers,
+ * or of pairs of 32-bit integers (in lexicographic order).
+ * Runtime complexity : O(n*w), O(n) additional space
+ */
+template <typename RandomIt>
+void radix_sort(RandomIt first, RandomIt last) {
+  using value_type = typename ::std::iterator_traits<RandomIt>::value_type;
+  ::std::vector<value_type> buffer(last-first);
+  ::algorithms::sort::radix_sort(first, last, buffer.begin(),
+      [](const value_type &x){return radix_key(x);});
+}
+
+/**
+ * Below this size MSD radix sort buckets are sorted with pdqsort.
+ */
+static const int kMsdRadixThreshold = 64;
+
+template <typename RandomIt, typename Key>
+void msd_radix_sort_helper(RandomIt first, RandomIt last, Key key, int shift) {
+  using value_type = typename ::std::iterator_traits<RandomIt>::value_type;
+  ::std::size_t n = last-first;
+  if (n < kMsdRadixThreshold) {
+    ::algorithms::sort::pdqsort(first, last,
+        [&key](const value_type &a, const value_type &b){return key(a) < key(b);});
+    return;
+  }
+
+  auto digit = [&](const value_type &x) { return (key(x) >> shift) & 0xff; };
+  ::std::array<::std::size_t,256> next{}, end;
+  for (auto it=first; it!=last; ++it) ++next[digit(*it)];
+  ::std::size_t sum = 0;
+  for (int d=0; d<256; ++d) {
+    sum += next[d];
+    end[d] = sum;
+    next[d] = sum - next[d];
+  }
+
+  // American flag sort: move every element into its bucket in place
+  for (int b=0; b<256; ++b) {
+    while (next[b] < end[b]) {
+      auto d = digit(first[next[b]]);
+      if (d == static_cast<decltype(d)>(b)) ++next[b];
+      else ::std::iter_swap(first+next[b], first+next[d]++);
+    }
+  }
+
+  if (shift == 0) return;
+  ::std::size_t begin = 0;
+  for (int b=0; b<256; ++b) {
+    if (end[b]-begin > 1) msd_radix_sort_helper(first+begin, first+end[b], key, shift-8);
+    begin = end[b];
+  }
+}
+
+/**
+ * In-place MSD radix sort (American flag sort) of the range [first,last)
+ * by key(x), which must be an unsigned integer.
+ * Each pass distributes the elements into 256 buckets
+ * by swapping them directly into place, then the buckets
+ * are sorted recursively on the next byte.
+ * The sort is not stable.
+ * Runtime complexity : O(n*w), O(w) additional space
+ */
+template <typename RandomIt, typename Key>
+void msd_radix_sort(RandomIt first, RandomIt last, Key key) {
+  using key_type = decltype(key(*first));
+  static_assert(::std::is_unsigned_v<key_type>, "msd_radix_sort needs unsigned keys");
+  msd_radix_sort_helper(first, last, key, 8*(sizeof(key_type)-1));
+}
+
+/**
+ * In-place MSD radix sort of a range of integers,
+ * or of pairs of 32-bit integers (in lexicographic order).
+ */
+template <typename RandomIt>
+void msd_radix_sort(RandomIt first, RandomIt last) {
+  using value_type = typename ::std::iterator_traits<RandomIt>::value_type;
+  ::algorithms::sort::msd_radix_sort(first, last, [](const value_type &x){return radix_key(x);});
+}
+
+/**
+ * Above this size nth_element picks its pivot with Floyd-Rivest sampling.
+ */
+static const int kFloydRivestThreshold = 600;
+
+template <typename RandomIt, typename Compare>
+void nth_element_helper(RandomIt first, RandomIt nth, RandomIt last, Compare comp, int depth) {
+  using value_type = typename ::std::iterator_traits<RandomIt>::value_type;
+  while (last-first > kInsertionSortThreshold) {
+    if (depth-- == 0) {
+      ::std::partial_sort(first, nth+1, last, comp);
+      return;
+    }
+    auto n = last-first;
+    if (n > kFloydRivestThreshold) {
+      /**
+       * Floyd-Rivest: select nth recursively within a small
+       * range around its expected position, so that the element
+       * ending up in nth is a pivot very close to the target rank,
+       * and the partition below discards most of the range.
+       */
+      double z = ::std::log(static_cast<double>(n));
+      double s = 0.5*::std::exp(2*z/3);
+      double i = nth-first;
+      double sd = 0.5*::std::sqrt(z*s*(n-s)/n)*(i < n/2 ? -1 : 1);
+      auto l = static_cast<decltype(n)>(::std::max(0.0, ::std::min(i, i-i*s/n+sd)));
+      auto r = static_cast<decltype(n)>(::std::min(static_cast<double>(n), ::std::max(i+1, i+(n-i)*s/n+sd+1)));
+      nth_element_helper(first+l, nth, first+r, comp, depth);
+    }
+    else sort3(first, nth, last-1, comp);
+
+    // 3-way partition around the pivot, found in nth
+    value_type pivot = *nth;
+    auto lt = ::algorithms::array::partition_branchless(first, last,
+        [&](const value_type &x){return comp(x, pivot);});
+    auto gt = ::algorithms::array::partition_branchless(lt, last,
+        [&](const value_type &x){return !comp(pivot, x);});
+    if (nth < lt) last = lt;
+    else if (nth >= gt) first = gt;
+    else return;
+  }
+  ::algorithms::sort::insertion_sort(first, last, comp);
+}
+
+/**
+ * Rearrange the range [first,last) so that nth holds the element
+ * that would be there if the range was sorted, all the elements
+ * before nth are not greater, and all the elements after are not smaller.
+ * Introselect: a quickselect using the branchless 3-way partition
+ * and Floyd-Rivest pivot sampling for large ranges, which falls back
+ * to heap selection if the recursion goes too deep.
+ * Runtime complexity : O(n) expected, O(nlogn) worst case
+ */
+template <typename RandomIt, typename Compare>
+void nth_element(RandomIt first, RandomIt nth, RandomIt last, Compare comp) {
+  if (first == last || nth == last) return;
+  auto n = last-first;
+  int log2 = 0;
+  while (n >>= 1) ++log2;
+  nth_element_helper(first, nth, last, comp, 2*log2+2);
+}
+
+template <typename RandomIt>
+void nth_element(RandomIt first, RandomIt nth, RandomIt last) {
+  ::algorithms::sort::nth_element(first, nth, last, ::std::less<>());
+}
+
+/**
+ * Number of samples per bucket used to pick the splitters of parallel_sort.
+ */
+static const int kSampleSortOversampling = 32;
+
+/**
+ * Parallel sample sort of the range [first,last) on t threads
+ * (0 means one per hardware thread).
+ * A sorted random-ish sample of the input selects t-1 splitters;
+ * each thread counts, for its chunk of the input, the elements
+ * falling in each of the t buckets, the counts are prefix-summed
+ * to find where the (chunk,bucket) pairs go, each thread scatters
+ * its chunk into a scratch buffer, and finally each thread
+ * sorts one bucket with pdqsort and copies it back.
+ * Inputs smaller than a few chunks of kParallelMinChunk elements
+ * are processed on fewer threads.
+ * The sort is not stable.
+ * Runtime complexity : O((n/t)logn) expected, O(n) additional space
+ */
+template <typename RandomIt, typename Compare,
+          typename = ::std::enable_if_t<::std::is_invocable_r_v<bool, Compare&,
+            typename ::std::iterator_traits<RandomIt>::reference,
+            typename ::std::iterator_traits<RandomIt>::reference>>>
+void parallel_sort(RandomIt first, RandomIt last, Compare comp, unsigned t = 0) {
+  using value_type = typename ::std::iterator_traits<RandomIt>::value_type;
+  ::std::size_t n = last-first;
+  ::std::size_t c = parallel::chunks(n, t, array::kParallelMinChunk);
+  if (c == 1) {
+    ::algorithms::sort::pdqsort(first, last, comp);
+    return;
+  }
+
+  // pick c-1 splitters from an evenly strided sample
+  ::std::size_t m = c*kSampleSortOversampling;
+  ::std::vector<value_type> splitters(m);
+  for (::std::size_t i=0; i<m; ++i) splitters[i] = first[(2*i+1)*n/(2*m)];
+  ::algorithms::sort::pdqsort(splitters.begin(), splitters.end(), comp);
+  for (::std::size_t i=1; i<c; ++i) splitters[i-1] = splitters[i*kSampleSortOversampling];
+  splitters.resize(c-1);
+
+  auto bucket = [&](const value_type &x) {
+    return ::std::upper_bound(splitters.begin(), splitters.end(), x, comp)-splitters.begin();
+  };
+
+  // counts[i*c+b] is the number of elements of chunk i going to bucket b
+  ::std::vector<::std::size_t> counts(c*c), offsets(c*c+1);
+  parallel::for_chunks(n, c, array::kParallelMinChunk, [&](::std::size_t i, ::std::size_t b, ::std::size_t e) {
+    for (auto j=b; j<e; ++j) ++counts[i*c+bucket(first[j])];
+  });
+  // bucket-major order, so that each bucket is contiguous in the buffer
+  for (::std::size_t b=0, k=0; b<c; ++b) {
+    for (::std::size_t i=0; i<c; ++i, ++k) offsets[k+1] = offsets[k]+counts[i*c+b];
+  }
+
+  ::std::vector<value_type> buffer(n);
+  parallel::for_chunks(n, c, array::kParallelMinChunk, [&](::std::size_t i, ::std::size_t b, ::std::size_t e) {
+    ::std::vector<::std::size_t> next(c);
+    for (::std::size_t k=0; k<c; ++k) next[k] = offsets[k*c+i];
+    for (auto j=b; j<e; ++j) buffer[next[bucket(first[j])]++] = ::std::move(first[j]);
+  });
+  parallel::for_chunks(c, c, 1, [&](::std::size_t, ::std::size_t b, ::std::size_t e) {
+    for (auto k=b; k<e; ++k) {
+      auto bb = buffer.begin()+offsets[k*c], be = buffer.begin()+offsets[(k+1)*c];
+      ::algorithms::sort::pdqsort(bb, be, comp);
+      ::std::move(bb, be, first+offsets[k*c]);
+    }
+  });
+}
+
+template <typename RandomIt>
+void parallel_sort(RandomIt first, RandomIt last, unsigned t = 0) {
+  ::algorithms::sort::parallel_sort(first, last, ::std::less<>(), t);
+}
+
+} // sort
+} // algorithms
+
+#endif
@@ -0,0 +1,290 @@
+#ifndef _SORTED_SET_
+#define _SORTED_SET_
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include "parallel.hpp"
+#include "partition.hpp"
+
+namespace algorithms {
+namespace array {
+
+/**
+ * Remove the consecutive duplicates of the sorted range [first,last),
+ * and return its new end.
+ * Every element is written to the slot after the last kept one,
+ * which is only kept (advancing the write position by one)
+ * if the element differs from the last kept one,
+ * so that there are no unpredictable branches.
+ * Runtime complexity : O(n)
+ */
+template <typename ForwardIt>
+ForwardIt dedup(ForwardIt first, ForwardIt last) {
+  using value_type = typename ::std::iterator_traits<ForwardIt>::value_type;
+  if (first == last) return last;
+  auto w = first;
+  for (auto it=::std::next(first); it!=last; ++it) {
+    ::std::advance(w, !(*it == *w));
+    if constexpr (::std::is_trivially_copyable_v<value_type>) *w = *it;
+    else if (w != it) *w = ::std::move(*it);
+  }
+  return ::std::next(w);
+}
+
+/**
+ * Parallel dedup on t threads (0 means one per hardware thread):
+ * every chunk is deduplicated in place, dropping its leading elements
+ * equal to the last element of the previous chunk (a run of equal
+ * elements may cross the boundary), and the chunks are then moved together.
+ * Runtime complexity : O(n/t) deduplication, O(n) compaction
+ */
+template <typename RandomIt>
+RandomIt parallel_dedup(RandomIt first, RandomIt last, unsigned t = 0) {
+  ::std::size_t n = last-first;
+  ::std::size_t c = parallel::chunks(n, t, kParallelMinChunk);
+  // the boundaries are compared before the chunks are modified,
+  // binary searching the end of the run continuing into every chunk
+  ::std::vector<::std::size_t> drop(c, 0);
+  for (::std::size_t i=1; i<c; ++i) {
+    ::std::size_t b = n*i/c, e = n*(i+1)/c;
+    drop[i] = ::std::upper_bound(first+b, first+e, first[b-1])-(first+b);
+  }
+  ::std::vector<::std::pair<::std::size_t,::std::size_t>> kept(c);
+  parallel::for_chunks(n, t, kParallelMinChunk, [&](::std::size_t i, ::std::size_t b, ::std::size_t e) {
+    b += drop[i];
+    kept[i] = {b, ::algorithms::array::dedup(first+b, first+e)-first};
+  });
+  auto w = first;
+  for (auto &k : kept) w = ::std::move(first+k.first, first+k.second, w);
+  return w;
+}
+
+/**
+ * Return the first position in the sorted range [first,last)
+ * not less than x, looking at first, first+1, first+3, first+7, ...
+ * and then binary searching the last gap: when the position is
+ * at distance d from first, this takes O(logd) comparisons.
+ */
+template <typename RandomIt, typename T>
+RandomIt gallop(RandomIt first, RandomIt last, const T &x) {
+  typename ::std::iterator_traits<RandomIt>::difference_type n = last-first, lo = 0, step = 1;
+  while (lo+step-1 < n && first[lo+step-1] < x) {
+    lo += step;
+    step *= 2;
+  }
+  return ::std::lower_bound(first+lo, first+::std::min(n, lo+step-1), x);
+}
+
+// the galloping versions are used above this size ratio
+static const ::std::size_t kGallopRatio = 32;
+
+/**
+ * Write the intersection of the sorted sets [a_first,a_last)
+ * and [b_first,b_last) starting at out, and return the end of the output.
+ * When the sizes are close, the sets are merged, advancing
+ * both positions branchlessly by the outcome of the comparisons;
+ * when one set is more than kGallopRatio times larger,
+ * the elements of the smaller one are galloped to in the larger one.
+ * Runtime complexity : O(min(n+m, min(n,m)log(max(n,m)/min(n,m))))
+ */
+template <typename RandomIt1, typename RandomIt2, typename OutputIt>
+OutputIt sorted_intersection(RandomIt1 a_first, RandomIt1 a_last,
+                             RandomIt2 b_first, RandomIt2 b_last, OutputIt out) {
+  ::std::size_t n = a_last-a_first, m = b_last-b_first;
+  if (n > kGallopRatio*m) {
+    return ::algorithms::array::sorted_intersection(b_first, b_last, a_first, a_last, out);
+  }
+  if (m > kGallopRatio*n) {
+    for (; a_first!=a_last && b_first!=b_last; ++a_first) {
+      b_first = ::algorithms::array::gallop(b_first, b_last, *a_first);
+      if (b_first != b_last && !(*a_first < *b_first)) *out++ = *a_first;
+    }
+    return out;
+  }
+  while (a_first != a_last && b_first != b_last) {
+    const auto &x = *a_first;
+    const auto &y = *b_first;
+    bool less = x < y, greater = y < x;
+    if (!less && !greater) *out++ = x;
+    a_first += !greater;
+    b_first += !less;
+  }
+  return out;
+}
+
+/**
+ * Write the union of the sorted sets [a_first,a_last)
+ * and [b_first,b_last) starting at out, and return the end of the output.
+ * Runtime complexity : O(n+m)
+ */
+template <typename RandomIt1, typename RandomIt2, typename OutputIt>
+OutputIt sorted_union(RandomIt1 a_first, RandomIt1 a_last,
+                      RandomIt2 b_first, RandomIt2 b_last, OutputIt out) {
+  while (a_first != a_last && b_first != b_last) {
+    if (*b_first < *a_first) *out++ = *b_first++;
+    else {
+      if (!(*a_first < *b_first)) ++b_first;
+      *out++ = *a_first++;
+    }
+  }
+  out = ::std::copy(a_first, a_last, out);
+  return ::std::copy(b_first, b_last, out);
+}
+
+/**
+ * Write the difference of the sorted sets [a_first,a_last)
+ * and [b_first,b_last), the elements of the first not in the second,
+ * starting at out, and return the end of the output.
+ * When one set is more than kGallopRatio times larger,
+ * the elements of the smaller one are galloped to in the larger one,
+ * and the runs of the first set between them are copied as a block.
+ * Runtime complexity : O(n+m) (see sorted_intersection with galloping)
+ */
+template <typename RandomIt1, typename RandomIt2, typename OutputIt>
+OutputIt sorted_difference(RandomIt1 a_first, RandomIt1 a_last,
+                           RandomIt2 b_first, RandomIt2 b_last, OutputIt out) {
+  ::std::size_t n = a_last-a_first, m = b_last-b_first;
+  if (n > kGallopRatio*m) {
+    for (; b_first!=b_last && a_first!=a_last; ++b_first) {
+      auto it = ::algorithms::array::gallop(a_first, a_last, *b_first);
+      out = ::std::copy(a_first, it, out);
+      a_first = (it != a_last && !(*b_first < *it)) ? it+1 : it;
+    }
+    return ::std::copy(a_first, a_last, out);
+  }
+  if (m > kGallopRatio*n) {
+    for (; a_first!=a_last; ++a_first) {
+      b_first = ::algorithms::array::gallop(b_first, b_last, *a_first);
+      if (b_first == b_last || *a_first < *b_first) *out++ = *a_first;
+    }
+    return out;
+  }
+  while (a_first != a_last && b_first != b_last) {
+    if (*a_first < *b_first) *out++ = *a_first++;
+    else {
+      if (!(*b_first < *a_first)) ++a_first;
+      ++b_first;
+    }
+  }
+  return ::std::copy(a_first, a_last, out);
+}
+
+/**
+ * Apply the sorted set operation op to [a_first,a_last) and [b_first,b_last)
+ * on t threads (0 means one per hardware thread), writing the output
+ * starting at out, and return its end.
+ * The first set is split in chunks, and the second at the lower bounds
+ * of the first elements of the chunks, so that every pair of chunks
+ * covers a disjoint range of values; each thread writes the output
+ * of its chunks to its own buffer, and the buffers are copied
+ * to the output in parallel.
+ */
+template <typename RandomIt1, typename RandomIt2, typename RandomIt3, typename Op>
+RandomIt3 parallel_sorted_helper(RandomIt1 a_first, RandomIt1 a_last,
+                                 RandomIt2 b_first, RandomIt2 b_last,
+                                 RandomIt3 out, unsigned t, Op op) {
+  using value_type = typename ::std::iterator_traits<RandomIt1>::value_type;
+  ::std::size_t n = a_last-a_first;
+  ::std::size_t c = parallel::chunks(n+(b_last-b_first), t, kParallelMinChunk);
+  if (c == 1 || n < c) return op(a_first, a_last, b_first, b_last, out);
+  ::std::vector<::std::vector<value_type>> buffers(c);
+  parallel::for_chunks(n, c, 1, [&](::std::size_t i, ::std::size_t b, ::std::size_t e) {
+    auto bb = b == 0 ? b_first : ::std::lower_bound(b_first, b_last, a_first[b]);
+    auto be = e == n ? b_last : ::std::lower_bound(b_first, b_last, a_first[e]);
+    op(a_first+b, a_first+e, bb, be, ::std::back_inserter(buffers[i]));
+  });
+  ::std::vector<::std::size_t> offsets(c+1, 0);
+  for (::std::size_t i=0; i<c; ++i) offsets[i+1] = offsets[i]+buffers[i].size();
+  parallel::for_chunks(c, c, 1, [&](::std::size_t, ::std::size_t b, ::std::size_t e) {
+    for (::std::size_t i=b; i<e; ++i) ::std::copy(buffers[i].begin(), buffers[i].end(), out+offsets[i]);
+  });
+  return out+offsets[c];
+}
+
+/**
+ * Parallel versions of sorted_intersection, sorted_union
+ * and sorted_difference, on t threads (0 means one per hardware thread).
+ * Runtime complexity : O((n+m)/t)
+ */
+template <typename RandomIt1, typename RandomIt2, typename RandomIt3>
+RandomIt3 parallel_sorted_intersection(RandomIt1 a_first, RandomIt1 a_last,
+                                       RandomIt2 b_first, RandomIt2 b_last,
+                                       RandomIt3 out, unsigned t = 0) {
+  return parallel_sorted_helper(a_first, a_last, b_first, b_last, out, t, [](auto... args) {
+    return ::algorithms::array::sorted_intersection(args...);
+  });
+}
+
+template <typename RandomIt1, typename RandomIt2, typename RandomIt3>
+RandomIt3 parallel_sorted_union(RandomIt1 a_first, RandomIt1 a_last,
+                                RandomIt2 b_first, RandomIt2 b_last,
+                                RandomIt3 out, unsigned t = 0) {
+  return parallel_sorted_helper(a_first, a_last, b_first, b_last, out, t, [](auto... args) {
+    return ::algorithms::array::sorted_union(args...);
+  });
+}
+
+template <typename RandomIt1, typename RandomIt2, typename RandomIt3>
+RandomIt3 parallel_sorted_difference(RandomIt1 a_first, RandomIt1 a_last,
+                                     RandomIt2 b_first, RandomIt2 b_last,
+                                     RandomIt3 out, unsigned t = 0) {
+  return parallel_sorted_helper(a_first, a_last, b_first, b_last, out, t, [](auto... args) {
+    return ::algorithms::array::sorted_difference(args...);
+  });
+}
+
+/**
+ * Merge the k sorted ranges [r.first,r.second) for r in [first,last),
+ * writing the output starting at out, and return its end.
+ * The heads of the ranges are the leaves of a loser tree:
+ * a complete binary tree with k leaves, whose internal nodes
+ * keep the loser of the match between the winners of their subtrees,
+ * and whose root keeps the overall winner.
+ * When the winner is replaced by the next element of its range,
+ * only the matches on its path to the root are replayed,
+ * against the losers stored there: exactly ceil(logk) comparisons
+ * per element, against up to 2logk for a binary heap.
+ * Equal elements are taken from the earlier range first.
+ * Runtime complexity : O(nlogk), for n elements in total
+ */
+template <typename InputIt, typename OutputIt>
+OutputIt kway_merge(InputIt first, InputIt last, OutputIt out) {
+  ::std::vector<typename ::std::iterator_traits<InputIt>::value_type> runs(first, last);
+  ::std::size_t k = runs.size();
+  if (k == 0) return out;
+  // whether the head of run a goes before the head of run b
+  auto before = [&runs](::std::size_t a, ::std::size_t b) {
+    if (runs[a].first == runs[a].second) return false;
+    if (runs[b].first == runs[b].second) return true;
+    if (*runs[b].first < *runs[a].first) return false;
+    return *runs[a].first < *runs[b].first || a < b;
+  };
+  // tree[1..k-1]: losers of the internal nodes, tree[0]: winner
+  ::std::vector<::std::size_t> tree(k);
+  ::std::vector<::std::size_t> winner(2*k);
+  for (::std::size_t i=0; i<k; ++i) winner[k+i] = i;
+  for (::std::size_t node=k-1; node>=1; --node) {
+    ::std::size_t l = winner[2*node], r = winner[2*node+1];
+    bool left = before(l, r);
+    winner[node] = left ? l : r;
+    tree[node] = left ? r : l;
+  }
+  tree[0] = winner[1];
+  while (runs[tree[0]].first != runs[tree[0]].second) {
+    ::std::size_t w = tree[0];
+    *out++ = *runs[w].first++;
+    for (::std::size_t node=(k+w)/2; node>=1; node/=2) {
+      if (before(tree[node], w)) ::std::swap(tree[node], w);
+    }
+    tree[0] = w;
+  }
+  return out;
+}
+
+} // array
+} // algorithms
+
+#endif
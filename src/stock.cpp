@@ -0,0 +1,66 @@
+#include "stock.hpp"
+#include <limits>
+
+namespace algorithms {
+namespace array {
+
+/*********** buy_and_sell_stock_k *************/
+double buy_and_sell_stock_k(const ::std::vector<double> &v, int k) {
+  return buy_and_sell_stock_k(v.begin(), v.end(), k);
+}
+
+/*********** online_stock_profit *************/
+void online_stock_profit::push(double price) {
+  if (_ticks++ == 0) ::std::fill(_buy.begin(), _buy.end(), -price);
+  /**
+   * Buying and selling on the same tick yields no profit,
+   * so the balances can be updated in place, in increasing order of j.
+   */
+  double prev_sell = 0.0;
+  for (::std::size_t j=0; j<_buy.size(); ++j) {
+    _buy[j] = ::std::max(_buy[j], prev_sell-price);
+    _sell[j] = ::std::max(_sell[j], _buy[j]+price);
+    prev_sell = _sell[j];
+  }
+}
+
+/*********** sliding_stock_profit *************/
+sliding_stock_profit::summary sliding_stock_profit::empty() {
+  static const double kInf = ::std::numeric_limits<double>::infinity();
+  return {kInf, -kInf, 0.0};
+}
+
+sliding_stock_profit::summary sliding_stock_profit::combine(const summary &older, const summary &newer) {
+  return {::std::min(older.min, newer.min),
+          ::std::max(older.max, newer.max),
+          ::std::max({older.best, newer.best, newer.max-older.min})};
+}
+
+void sliding_stock_profit::pop() {
+  if (_front_size == 0) {
+    // the newest price goes to the bottom of the front stack
+    for (int i=_back_size-1; i>=0; --i) {
+      summary s{_back[i], _back[i], 0.0};
+      _front[_front_size] = _front_size?combine(s, _front[_front_size-1]):s;
+      ++_front_size;
+    }
+    _back_size = 0;
+    _back_summary = empty();
+  }
+  --_front_size;
+}
+
+void sliding_stock_profit::push(double price) {
+  if (_w <= 0) return;
+  if (size() == _w) pop();
+  _back[_back_size++] = price;
+  _back_summary = combine(_back_summary, {price, price, 0.0});
+}
+
+double sliding_stock_profit::best() const {
+  if (_front_size == 0) return _back_summary.best;
+  return combine(_front[_front_size-1], _back_summary).best;
+}
+
+} // array
+} // algorithms
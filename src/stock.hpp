@@ -0,0 +1,155 @@
+#ifndef _STOCK_
+#define _STOCK_
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <utility>
+#include "sort.hpp"
+
+namespace algorithms {
+namespace array {
+
+/**
+ * Given an array v of n elements of type double,
+ * denoting the daily stock price, and a non-negative integer k,
+ * return the maximum profit that could be made by buying
+ * and then selling one share of that stock at most k times.
+ * Runtime complexity : O(n), independently of k
+ */
+double buy_and_sell_stock_k(const ::std::vector<double> &v, int k);
+
+/**
+ * Range overload of buy_and_sell_stock_k.
+ */
+template <typename RandomIt>
+double buy_and_sell_stock_k(RandomIt first, RandomIt last, int k) {
+  using diff = typename ::std::iterator_traits<RandomIt>::difference_type;
+  auto a = first;
+  diff n = last-first;
+
+  /**
+   * Decompose the prices into (valley,peak) pairs, i.e.
+   * maximal increasing runs, keeping a stack of the pairs
+   * which might still be merged with the following ones.
+   * When a new pair (v,p) arrives:
+   *  - pairs on the stack with a higher valley than a[v] can never
+   *    be extended past v with profit, since buying at v is better:
+   *    they are popped and their profit is final;
+   *  - pairs on the stack with a peak lower than a[p] (and a valley
+   *    not higher than a[v]) can be merged with (v,p), which is
+   *    the same as doing the two transactions (vt,pt) and (v,p),
+   *    minus the transaction (v,pt) going down from pt to v:
+   *    the profit a[pt]-a[v] of doing both instead of the merged one
+   *    is final, and the merged pair (vt,p) replaces (v,p).
+   * Every profit collected in this way is the gain of one more
+   * transaction, and the best k transactions are the k largest profits.
+   * Every pair is pushed and popped once, hence the whole decomposition
+   * takes O(n), and the k largest profits are found in O(n) with nth_element.
+   */
+  ::std::vector<::std::pair<diff,diff>> vps;
+  ::std::vector<double> profits;
+  diff v = 0, p = -1;
+  while (true) {
+    for (v = p+1; v+1 < n && a[v] >= a[v+1]; ++v);
+    for (p = v; p+1 < n && a[p] <= a[p+1]; ++p);
+    if (p <= v) break;
+    while (!vps.empty() && a[v] < a[vps.back().first]) {
+      profits.push_back(a[vps.back().second]-a[vps.back().first]);
+      vps.pop_back();
+    }
+    while (!vps.empty() && a[p] >= a[vps.back().second]) {
+      profits.push_back(a[vps.back().second]-a[v]);
+      v = vps.back().first;
+      vps.pop_back();
+    }
+    vps.emplace_back(v,p);
+  }
+  for (auto &vp : vps) profits.push_back(a[vp.second]-a[vp.first]);
+
+  if (k <= 0) return 0.0;
+  if (static_cast<::std::size_t>(k) < profits.size()) {
+    ::algorithms::sort::nth_element(profits.begin(), profits.begin()+k, profits.end(), ::std::greater<>());
+    profits.resize(k);
+  }
+  return ::std::accumulate(profits.begin(), profits.end(), 0.0);
+}
+
+/**
+ * Maintain the maximum profit that could be made
+ * by buying and selling one share of a stock at most k times,
+ * over a stream of prices read one tick at a time.
+ * After the construction, push does not allocate.
+ * Runtime complexity : O(k) per tick, that is O(1) for fixed k
+ */
+class online_stock_profit {
+public:
+  explicit online_stock_profit(int k) :
+    _buy(::std::max(k,0)), _sell(::std::max(k,0), 0.0), _ticks(0) {};
+  void push(double price);
+  double best() const {
+    return _sell.empty()?0.0:_sell.back();
+  }
+  long long ticks() const {
+    return _ticks;
+  }
+
+private:
+  // _buy[j] (_sell[j]): best balance after the j-th buy (sell)
+  ::std::vector<double> _buy;
+  ::std::vector<double> _sell;
+  long long _ticks;
+};
+
+/**
+ * Maintain the maximum profit that could be made
+ * by buying and then selling one share of a stock
+ * within the last w ticks of a stream of prices
+ * (a window of w <= 0 ticks is always empty).
+ * After the construction, push does not allocate.
+ * Runtime complexity : O(1) amortized per tick
+ */
+class sliding_stock_profit {
+public:
+  explicit sliding_stock_profit(int w) :
+    _w(::std::max(w, 0)), _front(_w), _back(_w), _front_size(0), _back_size(0),
+    _back_summary(empty()) {};
+  void push(double price);
+  double best() const;
+  int size() const {
+    return _front_size+_back_size;
+  }
+
+private:
+  /**
+   * Summary of a window: minimum and maximum price,
+   * and best profit within the window.
+   * Summaries of consecutive windows can be combined in O(1),
+   * so the window is kept as a queue made of two stacks:
+   * the back stack receives the new prices and keeps the summary
+   * of all of them, the front stack keeps, for each of its prices,
+   * the summary of it and all the prices after it in the front stack.
+   * When the front stack is empty, the back stack is moved onto it.
+   */
+  struct summary {
+    double min;
+    double max;
+    double best;
+  };
+  static summary empty();
+  static summary combine(const summary &older, const summary &newer);
+  void pop();
+
+  int _w;
+  ::std::vector<summary> _front;
+  ::std::vector<double> _back;
+  int _front_size;
+  int _back_size;
+  summary _back_summary;
+};
+
+} // array
+} // algorithms
+
+#endif
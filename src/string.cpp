@@ -1,19 +1,62 @@
 #include "string.hpp"
+#include "parallel.hpp"
 #include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
 #include <unordered_map>
 #include <sstream>
+#include <limits>
+#include <string_view>
 
 namespace algorithms {
 namespace string {
 
 /*********** is_palyndrome *************/
-bool is_palyndrome(const ::std::string &s) {
-  for (int i=0; i<s.size()/2; ++i) {
-    if (s[i] != s[s.size()-1-i]) return false;
+namespace {
+inline ::std::uint64_t load_word(const char *p) {
+  ::std::uint64_t w;
+  ::std::memcpy(&w, p, sizeof(w));
+  return w;
+}
+
+inline ::std::uint64_t reverse_bytes(::std::uint64_t w) {
+#if defined(__GNUC__)
+  return __builtin_bswap64(w);
+#else
+  w = (w & 0x00FF00FF00FF00FFULL) << 8 | (w >> 8 & 0x00FF00FF00FF00FFULL);
+  w = (w & 0x0000FFFF0000FFFFULL) << 16 | (w >> 16 & 0x0000FFFF0000FFFFULL);
+  return w << 32 | w >> 32;
+#endif
+}
+
+// compare the 8 characters from p with the 8 before q, in reverse
+inline ::std::uint64_t mirror_diff(const char *p, const char *q) {
+  return load_word(p) ^ reverse_bytes(load_word(q-8));
+}
+} // anonymous
+
+bool is_palyndrome(const char *first, const char *last) {
+  ::std::size_t half = (last-first)/2;
+  const char *mid = first+half;
+  for (; first+32<=mid; first+=32, last-=32) {
+    ::std::uint64_t diff = mirror_diff(first, last) | mirror_diff(first+8, last-8)
+                         | mirror_diff(first+16, last-16) | mirror_diff(first+24, last-24);
+    if (diff) return false;
+  }
+  for (; first+8<=mid; first+=8, last-=8) {
+    if (mirror_diff(first, last)) return false;
+  }
+  for (; first<mid; ++first) {
+    if (*first != *--last) return false;
   }
   return true;
 }
 
+bool is_palyndrome(const ::std::string &s) {
+  return is_palyndrome(s.data(), s.data()+s.size());
+}
+
 /*********** string_to_int *************/
 int string_to_int(const ::std::string &s) {
   int result = 0;
@@ -37,16 +80,107 @@ int string_to_int(const ::std::string &s) {
   return result;
 }
 
-/*********** count_substrings *************/
-void reverse_words(::std::string *sp) {
-  ::std::string &s = *sp;
-  for (int i=0; i<s.size();) {
-    int j = i;
-    while(j<s.size() && s[j]!=' ') ++j;
-    ::std::reverse(s.begin()+i,s.begin()+j);
-    i=j+1;
+/*********** reverse_words *************/
+namespace {
+const ::std::size_t kReverseMinChunk = 1<<16;
+const ::std::uint64_t kOnes = 0x0101010101010101ULL;
+const ::std::uint64_t kHighs = 0x8080808080808080ULL;
+
+inline void store_word(char *p, ::std::uint64_t w) {
+  ::std::memcpy(p, &w, sizeof(w));
+}
+
+inline bool is_space(char c) {
+  unsigned char u = c;
+  return u == ' ' || (u >= '\t' && u <= '\r');
+}
+
+// the high bit of every whitespace byte of w, each byte tested
+// on its low 7 bits, which can not carry into the next byte
+inline ::std::uint64_t space_mask(::std::uint64_t w) {
+  ::std::uint64_t low = w & ~kHighs, x = w ^ (' '*kOnes);
+  ::std::uint64_t blank = ~(((x & ~kHighs) + ~kHighs) | x) & kHighs;
+  // low >= 9 and low < 14, with the high bit clear
+  ::std::uint64_t control = (low + (0x80-9)*kOnes) & ~(low + (0x80-14)*kOnes) & ~w & kHighs;
+  return blank | control;
+}
+
+// swap [a,a+n) with the reverse of [b-n,b), which do not overlap
+void swap_reversed(char *a, char *b, ::std::size_t n) {
+  ::std::size_t k = 0;
+  for (; k+8<=n; k+=8) {
+    ::std::uint64_t x = load_word(a+k), y = load_word(b-k-8);
+    store_word(a+k, reverse_bytes(y));
+    store_word(b-k-8, reverse_bytes(x));
+  }
+  for (; k<n; ++k) ::std::swap(a[k], *(b-k-1));
+}
+
+// the first run boundary at or after p
+char *run_boundary(char *first, char *p, char *last) {
+  if (p == first) return p;
+  bool space = is_space(p[-1]);
+  while (p < last && is_space(*p) == space) ++p;
+  return p;
+}
+
+// reverse the run [first,q) within [first,last)
+inline void reverse_run(char *first, char *q, char *last) {
+  ::std::size_t n = q-first;
+  if (n < 2) return;
+#if defined(__GNUC__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  if (n <= 8 && first+8 <= last) {
+    // reverse the n low bytes of a word, rewriting the other ones
+    ::std::uint64_t w = load_word(first), low = ~::std::uint64_t(0) >> (64-8*n);
+    store_word(first, (w & ~low) | (reverse_bytes(w) >> (64-8*n)));
+    return;
+  }
+#endif
+  swap_reversed(first, q, n/2);
+}
+
+// reverse every run of words or whitespace in [first,last)
+void reverse_runs(char *first, char *last) {
+  if (first == last) return;
+  char *start = first, *p = first;
+  bool space = is_space(*first);
+#if defined(__GNUC__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  // the runs ending in 8 bytes are found at once, from the bytes
+  // whose class differs from the previous byte's
+  for (; p+8<=last; p+=8) {
+    ::std::uint64_t m = space_mask(load_word(p));
+    ::std::uint64_t ends = (m ^ (m << 8 | (space ? 0x80 : 0))) & kHighs;
+    for (; ends; ends &= ends-1) {
+      char *q = p+__builtin_ctzll(ends)/8;
+      reverse_run(start, q, last);
+      start = q;
+    }
+    space = m >> 63;
+  }
+#endif
+  for (; p<last; ++p) {
+    if (is_space(*p) != space) {
+      reverse_run(start, p, last);
+      start = p;
+      space = !space;
+    }
   }
-  ::std::reverse(s.begin(),s.end());
+  reverse_run(start, last, last);
+}
+} // anonymous
+
+void reverse_words(char *first, char *last, unsigned t) {
+  ::std::size_t n = last-first;
+  parallel::for_chunks(n/2, t, kReverseMinChunk, [&](::std::size_t, ::std::size_t b, ::std::size_t e) {
+    swap_reversed(first+b, last-b, e-b);
+  });
+  parallel::for_chunks(n, t, kReverseMinChunk, [&](::std::size_t, ::std::size_t b, ::std::size_t e) {
+    reverse_runs(run_boundary(first, first+b, last), run_boundary(first, first+e, last));
+  });
+}
+
+void reverse_words(::std::string *sp) {
+  reverse_words(sp->data(), sp->data()+sp->size());
 }
 
 /*********** count_substrings *************/
@@ -65,14 +199,11 @@ int count_substrings(const ::std::string &s) {
 }
 
 /*********** find_lus_length *************/
-bool is_subsequence(const ::std::string &s1, int idx1, const ::std::string &s2, int idx2) {
-  if (s1.size() - idx1 > s2.size() - idx2) return false;
-  if (s1.size() - idx1 == 0) return true;
-  if (s1[idx1] == s2[idx2]) return is_subsequence(s1,idx1+1,s2,idx2+1);
-  return is_subsequence(s1,idx1,s2,idx2+1);
-}
+namespace {
+const ::std::size_t kLusMinChunk = 64;
+} // anonymous
 
-int find_lus_length(const ::std::vector<::std::string> &s) {
+int find_lus_length(const ::std::vector<::std::string> &s, unsigned t) {
   /**
    * The idea of the algorithm is that 
    * the longest uncommon substring, if it exists,
@@ -88,62 +219,232 @@ int find_lus_length(const ::std::vector<::std::string> &s) {
    * of some input string sj, j!=1.
    * But then also u, being a subsequence of s1 == x,
    * must be a subsequence of sj, hence a contradiction.
+   * Moreover, a string repeated in the input is not uncommon,
+   * and a string can only be a subsequence of a longer one,
+   * or of a copy of itself.
    */
-  int longest = -1;
-  for (int i=0; i<s.size(); ++i) {
-    bool found = false;
-    for (int j=0; !found && j<s.size(); ++j) {
-      if (i!=j && is_subsequence(s[i],0,s[j],0)) found = true;
+  ::std::unordered_map<::std::string_view, int> groups;
+  ::std::vector<int> distinct, copies;
+  for (int i=0; i<static_cast<int>(s.size()); ++i) {
+    auto it = groups.emplace(s[i], distinct.size()).first;
+    if (it->second == static_cast<int>(distinct.size())) {
+      distinct.push_back(i);
+      copies.push_back(0);
     }
-    if (!found) longest = ::std::max(longest,(int)s[i].size());
+    ++copies[it->second];
   }
-  return longest;
+  ::std::vector<int> order(distinct.size());
+  for (int i=0; i<static_cast<int>(order.size()); ++i) order[i] = i;
+  ::std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    return s[distinct[a]].size() > s[distinct[b]].size();
+  });
+
+  ::std::vector<subsequence_index> index;
+  index.reserve(order.size());
+  ::std::vector<int> candidates;
+  ::std::vector<char> uncommon;
+  for (::std::size_t b=0; b<order.size(); ) {
+    ::std::size_t len = s[distinct[order[b]]].size(), e = b;
+    candidates.clear();
+    for (; e<order.size() && s[distinct[order[e]]].size() == len; ++e) {
+      if (copies[order[e]] == 1) candidates.push_back(distinct[order[e]]);
+    }
+    // the strings longer than len are the first b ones
+    uncommon.assign(candidates.size(), 0);
+    parallel::for_chunks(candidates.size(), t, kLusMinChunk, [&](::std::size_t, ::std::size_t cb, ::std::size_t ce) {
+      for (::std::size_t c=cb; c<ce; ++c) {
+        const ::std::string &u = s[candidates[c]];
+        uncommon[c] = ::std::none_of(index.begin(), index.end(), [&](const subsequence_index &i) {
+          return i.contains(u);
+        });
+      }
+    });
+    if (::std::find(uncommon.begin(), uncommon.end(), 1) != uncommon.end()) return len;
+    for (; b<e; ++b) index.emplace_back(s[distinct[order[b]]]);
+  }
+  return -1;
+}
+
+/*********** is_subsequence *************/
+bool is_subsequence(const ::std::string &s1, const ::std::string &s2) {
+  ::std::size_t i = 0;
+  for (::std::size_t j=0; i<s1.size() && j<s2.size(); ++j) {
+    if (s1[i] == s2[j]) ++i;
+  }
+  return i == s1.size();
 }
 
 /*********** look_and_say *************/
 ::std::string look_and_say(int n) {
-  ::std::string current("1");
-  for (int i=2; i<=n; ++i) {
-    ::std::string next;
-    for (int j=0; j<current.size();) {      
-      char curchar=current[j];
-      int count=0;
-      while (j<current.size() && current[j]==curchar) {++j; ++count;};
-      next.append(::std::to_string(count)).push_back(curchar);
-    }
-    current = ::std::move(next);
-  }    
-  return current;
+  look_and_say_term term(n);
+  ::std::string result(term.size(), '\0');
+  term.write(0, result.size(), result.begin());
+  return result;
 }
 
 /*********** roman_to_integer *************/
 int roman_to_integer(const ::std::string &s) {
-  static ::std::unordered_map<char,int> m
-    = {{'I',1},{'V',5},{'X',10},{'L',50},{'C',100},{'D',500},{'M',1000}};
-  int result = 0;
-  for (int i=0; i<s.size(); ++i) {
-    if (i<s.size()-1 && m[s[i]]<m[s[i+1]]) result-=m[s[i]];
-    else result+=m[s[i]];
-  }
-  return result;
+  return parse_roman(s.data(), s.data()+s.size());
+}
+
+/*********** integer_to_roman *************/
+::std::string integer_to_roman(int n) {
+  char buffer[kMaxRomanLength];
+  return ::std::string(buffer, format_roman(n, buffer));
 }
 
 /*********** search *************/
+namespace {
+const ::std::size_t kSearchMinLane = 1<<10;
+
+// hash of the window shifted by one, dropping out and appending in,
+// from the hash h of the window, given the table of the rolling_hash of
+// base whose entry c is 2^61-1 minus the value dropped for c, plus one
+inline ::std::uint64_t search_roll(::std::uint64_t h, char out, char in, ::std::uint64_t base, const ::std::uint64_t *kept) {
+  ::std::uint64_t rest = kept[static_cast<unsigned char>(out)]+static_cast<unsigned char>(in);
+#if defined(__GNUC__) && defined(__SIZEOF_INT128__)
+  // a single reduction of the product plus the other terms, below 2^63
+  unsigned __int128 x = static_cast<unsigned __int128>(h)*base;
+  return mod_mersenne_helper(static_cast<::std::uint64_t>(x >> 61)+(static_cast<::std::uint64_t>(x) & kMersenne61)+rest);
+#else
+  return mod_mersenne_helper(mul_mod_helper(h, base)+rest);
+#endif
+}
+
+// first window of [b,e) equal to s, given the hash h of the window b, or e
+::std::size_t search_range(const ::std::string &t, const ::std::string &s, ::std::size_t b, ::std::size_t e,
+                           ::std::uint64_t h, ::std::uint64_t hs, ::std::uint64_t base, const ::std::uint64_t *kept) {
+  ::std::size_t m = s.size();
+  for (::std::size_t j=b; j<e; ++j) {
+    if (h == hs && !t.compare(j, m, s)) return j;
+    if (j+1 < e) h = search_roll(h, t[j], t[j+m], base, kept);
+  }
+  return e;
+}
+
+// first of the windows i, len+i, 2len+i and 3len+i before found
+// whose hash in h is hs and which is equal to s, or found
+::std::size_t search_lanes(const ::std::string &t, const ::std::string &s, ::std::size_t i, ::std::size_t len,
+                           const ::std::uint64_t *h, ::std::uint64_t hs, ::std::size_t found) {
+  for (::std::size_t k=0; k<4 && k*len+i<found; ++k) {
+    if (h[k] == hs && !t.compare(k*len+i, s.size(), s)) return k*len+i;
+  }
+  return found;
+}
+} // anonymous
+
 int search(const ::std::string &t, const ::std::string &s) {
-  static const long long kWidth = 256;
-  if (s.size()>t.size()) return -1;
-  long long hs=0, hw=0, power=1;
-  for (int i=0; i<s.size(); ++i) {
-    hs=kWidth*hs+s[i];
-    hw=kWidth*hw+t[i];
-    power*=kWidth;
-  }
-  if (hw==hs && !t.compare(0,s.size(),s)) return 0;
-  for (int j=1; j<=t.size()-s.size(); ++j) {
-    hw = kWidth*hw - power*t[j-1] + t[j+s.size()-1];
-    if (hw==hs && !t.compare(j,s.size(),s)) return j;
+  static const rolling_hash<> kHash;
+  if (s.size() > t.size()) return -1;
+  ::std::size_t m = s.size(), windows = t.size()-m+1;
+  const char *p = t.data();
+  auto hash = [&](const char *first) {
+    return kHash.hash(first, first+m)[0];
+  };
+  ::std::uint64_t hs = hash(s.data()), base = kHash.bases()[0];
+  ::std::uint64_t kept[256];
+  auto dropped = kHash.drops(kHash.power(m));
+  for (int c=0; c<256; ++c) kept[c] = kMersenne61-dropped[c][0]+1;
+  if (windows < 4*kSearchMinLane) {
+    ::std::size_t j = search_range(t, s, 0, windows, hash(p), hs, base, kept);
+    return j == windows ? -1 : j;
   }
-  return -1;
+
+  /**
+   * The windows are split into 4 lanes of len windows (the last one
+   * taking the remaining ones), whose hashes are rolled together so that
+   * the multiplications overlap, with a single branch for the 4 comparisons.
+   * A match ends the search in the first lane, and else only the lanes
+   * before it can hold an earlier one.
+   */
+  ::std::size_t len = windows/4, found = windows;
+  const char *q0 = p, *q1 = p+len, *q2 = p+2*len, *q3 = p+3*len;
+  ::std::uint64_t h0 = hash(q0), h1 = hash(q1), h2 = hash(q2), h3 = hash(q3);
+  for (::std::size_t i=0; ; ++i) {
+    if ((h0 == hs) | (h1 == hs) | (h2 == hs) | (h3 == hs)) {
+      ::std::uint64_t h[4] = {h0, h1, h2, h3};
+      found = search_lanes(t, s, i, len, h, hs, found);
+      if (found < len) return found;
+    }
+    if (i+1 == len) break;
+    h0 = search_roll(h0, q0[i], q0[i+m], base, kept);
+    h1 = search_roll(h1, q1[i], q1[i+m], base, kept);
+    h2 = search_roll(h2, q2[i], q2[i+m], base, kept);
+    h3 = search_roll(h3, q3[i], q3[i+m], base, kept);
+  }
+  if (found == windows && 4*len < windows) {
+    ::std::size_t j = 4*len-1;
+    found = search_range(t, s, j+1, windows, search_roll(h3, t[j], t[j+m], base, kept), hs, base, kept);
+  }
+  return found == windows ? -1 : found;
+}
+
+::std::vector<int> search_many(const ::std::string &t, const ::std::vector<::std::string> &patterns) {
+  static const rolling_hash<> kHash;
+  ::std::vector<int> result(patterns.size(), -1);
+  ::std::unordered_map<::std::size_t, ::std::vector<int>> lengths;
+  for (int i=0; i<static_cast<int>(patterns.size()); ++i) {
+    if (patterns[i].size() <= t.size()) lengths[patterns[i].size()].emplace_back(i);
+  }
+  for (auto &[m, group] : lengths) {
+    ::std::unordered_map<::std::uint64_t, ::std::vector<int>> hashes;
+    for (int i : group) hashes[kHash.hash(patterns[i])[0]].emplace_back(i);
+    ::std::size_t left = group.size();
+    auto hw = kHash.hash(t.data(), t.data()+m);
+    auto dropped = kHash.drops(kHash.power(m));
+    for (::std::size_t j=0; left; ++j) {
+      auto it = hashes.find(hw[0]);
+      if (it != hashes.end()) {
+        for (int i : it->second) {
+          if (result[i] == -1 && !t.compare(j, m, patterns[i])) {
+            result[i] = j;
+            --left;
+          }
+        }
+      }
+      if (j+m == t.size()) break;
+      hw = kHash.roll(hw, t[j], t[j+m], dropped);
+    }
+  }
+  return result;
+}
+
+::std::string longest_common_substring(const ::std::string &a, const ::std::string &b) {
+  static const rolling_hash<> kHash;
+  prefix_hash<> ha(a, kHash), hb(b, kHash);
+  // position in a of the first common substring of length m, or -1
+  auto common = [&](::std::size_t m) -> long long {
+    ::std::unordered_map<::std::uint64_t, ::std::vector<::std::size_t>> windows;
+    for (::std::size_t j=0; j+m<=b.size(); ++j) windows[hb.substr(j, m)[0]].emplace_back(j);
+    for (::std::size_t i=0; i+m<=a.size(); ++i) {
+      auto it = windows.find(ha.substr(i, m)[0]);
+      if (it == windows.end()) continue;
+      for (::std::size_t j : it->second) {
+        if (!a.compare(i, m, b, j, m)) return i;
+      }
+    }
+    return -1;
+  };
+  ::std::size_t lo = 0, hi = ::std::min(a.size(), b.size()), pos = 0;
+  while (lo < hi) {
+    ::std::size_t mid = lo+(hi-lo+1)/2;
+    long long p = common(mid);
+    if (p >= 0) {
+      lo = mid;
+      pos = p;
+    } else {
+      hi = mid-1;
+    }
+  }
+  return a.substr(pos, lo);
+}
+
+int search(const suffix_index<> &index, const ::std::string &s) {
+  return index.first(s);
+}
+
+int search(const fm_index<> &index, const ::std::string &s) {
+  return index.first(s);
 }
 
 /*********** word_distance *************/
@@ -156,11 +457,28 @@ word_distance::word_distance(const ::std::string &text) : _text(text) {
   }
 }
 
-int word_distance::distance(const ::std::string &w1, const ::std::string &w2) const {
-  auto it1 = _m.find(w1), it2 = _m.find(w2);
-  if (it1 == _m.end() || it2 == _m.end()) return -1;
+word_distance::word_distance(const ::std::string &text, const suffix_index<> &index) : _text(text), _index(&index), _starts(text.size()) {
+  for (::std::size_t i=0; i<text.size(); ++i) {
+    auto space = [](char c) { return ::std::isspace(static_cast<unsigned char>(c)); };
+    if (!space(text[i]) && (i == 0 || space(text[i-1]))) _starts.set(i);
+  }
+  _starts.build();
+}
 
-  const auto &l1 = it1->second, &l2 = it2->second;
+::std::vector<int> word_distance::locate_words(const ::std::string &w) const {
+  ::std::vector<int> result;
+  auto space = [](char c) { return ::std::isspace(static_cast<unsigned char>(c)); };
+  if (w.empty() || ::std::any_of(w.begin(), w.end(), space)) return result;
+  for (int p : _index->locate(w)) {
+    ::std::size_t e = p+w.size();
+    if (_starts[p] && (e == _text.size() || space(_text[e]))) {
+      result.push_back(_starts.rank1(p));
+    }
+  }
+  return result;
+}
+
+int word_distance::closest(const ::std::vector<int> &l1, const ::std::vector<int> &l2) {
   int idx1 = 0, idx2 = 0;
   int min_dist = ::std::numeric_limits<int>::max();
   while (idx1 < l1.size() && idx2 < l2.size()) {
@@ -171,5 +489,17 @@ int word_distance::distance(const ::std::string &w1, const ::std::string &w2) co
   return min_dist;
 }
 
+int word_distance::distance(const ::std::string &w1, const ::std::string &w2) const {
+  if (_index) {
+    auto l1 = locate_words(w1), l2 = locate_words(w2);
+    if (l1.empty() || l2.empty()) return -1;
+    return closest(l1, l2);
+  }
+
+  auto it1 = _m.find(w1), it2 = _m.find(w2);
+  if (it1 == _m.end() || it2 == _m.end()) return -1;
+  return closest(it1->second, it2->second);
+}
+
 } // string
 } // algorithms
@@ -1,18 +1,45 @@
 #ifndef _STRING_
 #define _STRING_
+#include <cstddef>
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include "fm_index.hpp"
+#include "look_and_say.hpp"
+#include "parallel.hpp"
+#include "rolling_hash.hpp"
+#include "roman.hpp"
+#include "subsequence.hpp"
+#include "suffix_array.hpp"
 
 namespace algorithms {
 namespace string {
 
+const ::std::size_t kPalyndromeMinChunk = 1<<12;
+
 /**
  * Check if a string s of n characters
  * is a palyndrome or not.
+ * The characters are compared 32 at a time, as four 64-bit words
+ * loaded from the front and four from the back, whose bytes are
+ * reversed, with a single branch on the OR of their differences.
  * Runtime complexity : O(n)
  */
 bool is_palyndrome(const ::std::string &s);
+bool is_palyndrome(const char *first, const char *last);
+
+/**
+ * Check if each of the strings in [first,last) is a palyndrome,
+ * writing the results starting at out, on t threads
+ * (0 means one per hardware thread), each checking a chunk of them.
+ * Runtime complexity : O(n/t), for n characters in all
+ */
+template <typename RandomIt, typename RandomOutputIt>
+void is_palyndrome_many(RandomIt first, RandomIt last, RandomOutputIt out, unsigned t = 0) {
+  parallel::for_chunks(last-first, t, kPalyndromeMinChunk, [&](::std::size_t, ::std::size_t b, ::std::size_t e) {
+    for (::std::size_t i=b; i<e; ++i) out[i] = is_palyndrome(first[i]);
+  });
+}
 
 /**
  * Convert a string s of n characters
@@ -36,6 +63,21 @@ int string_to_int(const ::std::string &s);
  */
 void reverse_words(::std::string *sp);
 
+/**
+ * Reverse the order of the words in the buffer [first,last)
+ * (e.g. a memory mapped file) in place, where words are separated
+ * by runs of whitespace (as std::isspace in the C locale), so that
+ * the sequence of words and whitespace runs is reversed, each of them
+ * kept as it is. The whole buffer is reversed, swapping 8 bytes from each
+ * end at a time, and then every run is reversed back, finding the run
+ * boundaries in 8 bytes at once from a bit mask of their whitespace.
+ * Both passes run on t threads (0 means one per hardware thread):
+ * the first one on mirrored chunks of the two halves, the second one
+ * on chunks whose boundaries are moved to the next run boundary.
+ * Runtime complexity : O(n/t)
+ */
+void reverse_words(char *first, char *last, unsigned t = 0);
+
 /**
  * Given a string s of n characters, 
  * count how many palindromic substrings there are in this string.
@@ -59,9 +101,21 @@ int count_substrings(const ::std::string &s);
  * A subsequence is a sequence that can be derived 
  * from one sequence by deleting some characters 
  * without changing the order of the remaining elements. 
- * Runtime complexity : O(x*n2)
+ * Identical strings are grouped by hashing, and the candidates
+ * are tried from the longest, each against the strictly longer
+ * strings only (through their subsequence_index), so that the first
+ * length with an uncommon candidate is the answer. The candidates
+ * of a length are checked on t threads (0 means one per hardware thread).
+ * Runtime complexity : O(x*n2*logx/t) worst case
+ */
+int find_lus_length(const ::std::vector<::std::string> &s, unsigned t = 0);
+
+/**
+ * Check if s1 is a subsequence of s2, by a greedy scan of s2
+ * (see subsequence_index to check many strings against s2).
+ * Runtime complexity : O(|s2|)
  */
-int find_lus_length(const ::std::vector<::std::string> &s);
+bool is_subsequence(const ::std::string &s1, const ::std::string &s2);
 
 /**
  * The look-and-say sequence starts with 1.
@@ -74,8 +128,12 @@ int find_lus_length(const ::std::vector<::std::string> &s);
  * For example: 
  * 1; one 1; two 1s; one 2 and then one 1; ...
  * Write a program that takes as input an integer n
- * and returns the nth integer in the look-and-say sequence.a
- * Runtime complexity : O(n2^n)
+ * and returns the nth integer in the look-and-say sequence.
+ * The term is written through look_and_say_term, without building
+ * the previous ones, see it for the length or parts of large terms.
+ * Throws ::std::runtime_error for n above kMaxLookAndSay, whose length
+ * does not fit in 64 bits (nor in memory, long before it).
+ * Runtime complexity : O(L_n), where L_n ~ 1.3036^n is the length of the term
  */
 ::std::string look_and_say(int n);
 
@@ -94,18 +152,64 @@ int find_lus_length(const ::std::vector<::std::string> &s);
  * to the exceptions. For the exceptions, 
  * add the difference of the larger symbol and the smaller symbol.
  * Take as input a valid Roman number string s 
- * and return the integer it corresponds to.
+ * and return the integer it corresponds to
+ * (or -1 if s is not valid, see parse_roman).
+ * Runtime complexity : O(n)
  */
 int roman_to_integer(const ::std::string &s);
 
+/**
+ * Return the standard Roman numeral of n, from 1 to 3999
+ * (an empty string if n is out of range), see format_roman.
+ * Runtime complexity : O(1)
+ */
+::std::string integer_to_roman(int n);
+
 /**
  * Given two strings s (the "search string", length m)
  * and t (the "text string", length n),
  * find the first occurrence of s in t.
+ * The windows of t are hashed with a rolling_hash (modulo 2^61-1,
+ * with a random base), and compared with s when the hashes match,
+ * so that collisions only cost time. Long texts are scanned as
+ * 4 interleaved ranges of windows, whose hashes are rolled
+ * independently of each other, so that their multiplications overlap.
  * Runtime complexity : O(m+n) expected - Rabin-Karp algorithm
  */
 int search(const ::std::string &t, const ::std::string &s);
 
+/**
+ * Find the first occurrence in t of each of k patterns,
+ * returning -1 for the ones which do not occur.
+ * The patterns are grouped by length, and t is scanned once per length,
+ * looking up the hash of every window among the hashes of the patterns
+ * of that length, so that the cost of a scan does not depend
+ * on the number of patterns.
+ * Runtime complexity : O(n*l + M) expected, for l distinct lengths
+ *                      and M characters in the patterns
+ */
+::std::vector<int> search_many(const ::std::string &t, const ::std::vector<::std::string> &patterns);
+
+/**
+ * Return the longest common substring of a and b (the first one in a,
+ * among the longest). A common substring of length L means common
+ * substrings of every smaller length, so that L is found by binary
+ * search, checking each length by looking up the hashes of the windows
+ * of b among the ones of a (see prefix_hash), and comparing
+ * the characters when the hashes match.
+ * Runtime complexity : O((n+m)log(min(n,m))) expected
+ */
+::std::string longest_common_substring(const ::std::string &a, const ::std::string &b);
+
+/**
+ * Find the first occurrence of s in the text of index, built once
+ * for many searches in the same text, see suffix_index and fm_index.
+ * Runtime complexity : O(mlogn + occ) - suffix array
+ *                      O(m + occ*sample) - FM-index
+ */
+int search(const suffix_index<> &index, const ::std::string &s);
+int search(const fm_index<> &index, const ::std::string &s);
+
 /**
  * You have a large text file containing n words.
  * Given any two words, find the shortest distance 
@@ -115,15 +219,28 @@ int search(const ::std::string &t, const ::std::string &s);
  * solution?
  * Runtime complexity : O(n*w) - constructor
  *                      O(n1 + n2) - distance
+ * Alternatively, the words can be looked up in a suffix_index of the
+ * text, shared with other queries, instead of a map of every word:
+ * the occurrences of a word which are whole words are located,
+ * and mapped to word numbers by rank in a bitvector of the word starts.
+ * Runtime complexity : O(n) - constructor (besides the index)
+ *                      O(wlogn + occ1*logocc1 + occ2*logocc2) - distance
+ * In both cases, the text must outlive the object.
  */
 class word_distance {
 public:
   word_distance(const ::std::string &text);
+  word_distance(const ::std::string &text, const suffix_index<> &index);
   int distance(const ::std::string &w1, const ::std::string &w2) const;
 
 private:
+  ::std::vector<int> locate_words(const ::std::string &w) const;
+  static int closest(const ::std::vector<int> &l1, const ::std::vector<int> &l2);
+
   const std::string &_text;
   ::std::unordered_map<::std::string, ::std::vector<int>> _m;
+  const suffix_index<> *_index = nullptr;
+  rank_bitvector _starts;
 };
 
 } // string
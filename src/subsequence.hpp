@@ -0,0 +1,90 @@
+#ifndef _SUBSEQUENCE_
+#define _SUBSEQUENCE_
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "parallel.hpp"
+
+namespace algorithms {
+namespace string {
+
+/**
+ * Next occurrence automaton of a string t of n characters,
+ * answering whether strings are subsequences of t:
+ * the positions of every character in t are kept in increasing order,
+ * in one array sliced by character, and the next occurrence
+ * of a character c at or after a position is found by binary search
+ * in the slice of c. A query s is matched greedily, jumping
+ * to the next occurrence of each of its characters, unless s is
+ * so long that scanning t directly is cheaper.
+ * The index refers to t, which must outlive it.
+ * Runtime complexity : O(n) construction,
+ *                      O(min(|s|logn, n)) per query
+ */
+class subsequence_index {
+public:
+  explicit subsequence_index(const ::std::string &t) : _t(t), _start(kAlphabet+1, 0), _pos(t.size()) {
+    for (unsigned char c : t) ++_start[c+1];
+    for (int c=0; c<kAlphabet; ++c) _start[c+1] += _start[c];
+    ::std::vector<int> next(_start.begin(), _start.end()-1);
+    for (int i=0; i<static_cast<int>(t.size()); ++i) _pos[next[static_cast<unsigned char>(t[i])]++] = i;
+    for (int n=t.size(); n>1; n>>=1) ++_log;
+  }
+
+  /**
+   * Check if s is a subsequence of t.
+   */
+  bool contains(const ::std::string &s) const {
+    if (s.size() > _t.size()) return false;
+    if (s.size()*_log >= _t.size()) return scan(s);
+    int i = 0;
+    for (unsigned char c : s) {
+      auto b = _pos.begin()+_start[c], e = _pos.begin()+_start[c+1];
+      auto it = ::std::lower_bound(b, e, i);
+      if (it == e) return false;
+      i = *it+1;
+    }
+    return true;
+  }
+
+  /**
+   * Check if each of the strings in [first,last) is a subsequence of t,
+   * writing the results starting at out, on t threads
+   * (0 means one per hardware thread), each checking a chunk of the strings.
+   */
+  template <typename RandomIt, typename RandomOutputIt>
+  void contains_many(RandomIt first, RandomIt last, RandomOutputIt out, unsigned t = 0) const {
+    parallel::for_chunks(last-first, t, kMinChunk, [&](::std::size_t, ::std::size_t b, ::std::size_t e) {
+      for (::std::size_t i=b; i<e; ++i) out[i] = contains(first[i]);
+    });
+  }
+
+  ::std::size_t size() const {
+    return _t.size();
+  }
+
+private:
+  static const int kAlphabet = 256;
+  static const ::std::size_t kMinChunk = 256;
+
+  bool scan(const ::std::string &s) const {
+    ::std::size_t i = 0;
+    for (::std::size_t j=0; i<s.size() && j<_t.size(); ++j) {
+      if (s[i] == _t[j]) ++i;
+    }
+    return i == s.size();
+  }
+
+  const ::std::string &_t;
+  // the positions of the character c are _pos[_start[c].._start[c+1])
+  ::std::vector<int> _start;
+  ::std::vector<int> _pos;
+  ::std::size_t _log = 1;
+};
+
+} // string
+} // algorithms
+
+#endif
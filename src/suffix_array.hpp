@@ -0,0 +1,266 @@
+#ifndef _SUFFIX_ARRAY_
+#define _SUFFIX_ARRAY_
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace algorithms {
+namespace string {
+
+// suffix array of s, whose values are in [0,upper], by induced sorting
+// (SA-IS): the suffixes are classified as S (smaller than the next suffix)
+// or L (larger), the leftmost S suffixes of every run (LMS) are sorted
+// recursively on the string of the names of their substrings,
+// and the order of the others is induced from them.
+// s is a string of bytes, read as unsigned, or a vector of Index,
+// and the working arrays besides sa are freed before recursing
+template <typename Index, typename String>
+::std::vector<Index> sais_helper(const String &s, Index upper) {
+  using Char = typename String::value_type;
+  auto at = [&](Index i) {
+    return static_cast<Index>(static_cast<::std::make_unsigned_t<Char>>(s[i]));
+  };
+  Index n = s.size();
+  if (n == 0) return {};
+  if (n == 1) return {0};
+  if (n == 2) return at(0) < at(1) ? ::std::vector<Index>{0, 1} : ::std::vector<Index>{1, 0};
+
+  ::std::vector<bool> stype(n);
+  for (Index i=n-2; i>=0; --i) stype[i] = at(i) == at(i+1) ? stype[i+1] : at(i) < at(i+1);
+  auto is_lms = [&](Index i) {
+    return i > 0 && stype[i] && !stype[i-1];
+  };
+
+  // every bucket of a value starts with its L suffixes, at sum_l,
+  // followed by its S suffixes, at sum_s
+  ::std::vector<Index> sum_l, sum_s;
+  auto buckets = [&]() {
+    sum_l.assign(upper+1, 0);
+    sum_s.assign(upper+1, 0);
+    for (Index i=0; i<n; ++i) {
+      if (!stype[i]) ++sum_s[at(i)];
+      else ++sum_l[at(i)+1];
+    }
+    for (Index c=0; c<=upper; ++c) {
+      sum_s[c] += sum_l[c];
+      if (c < upper) sum_l[c+1] += sum_s[c];
+    }
+  };
+
+  ::std::vector<Index> sa(n);
+  auto induce = [&](const ::std::vector<Index> &lms) {
+    ::std::vector<Index> buf(sum_s);
+    ::std::fill(sa.begin(), sa.end(), -1);
+    for (Index d : lms) sa[buf[at(d)]++] = d;
+    ::std::copy(sum_l.begin(), sum_l.end(), buf.begin());
+    sa[buf[at(n-1)]++] = n-1;
+    for (Index i=0; i<n; ++i) {
+      Index v = sa[i];
+      if (v >= 1 && !stype[v-1]) sa[buf[at(v-1)]++] = v-1;
+    }
+    ::std::copy(sum_l.begin(), sum_l.end(), buf.begin());
+    // an S suffix is smaller than the next one, so its value is not upper
+    for (Index i=n-1; i>=0; --i) {
+      Index v = sa[i];
+      if (v >= 1 && stype[v-1]) sa[--buf[at(v-1)+1]] = v-1;
+    }
+  };
+  // the LMS positions, in increasing order
+  auto lms_positions = [&]() {
+    Index m = 0;
+    for (Index i=1; i<n; ++i) m += is_lms(i);
+    ::std::vector<Index> lms;
+    lms.reserve(m);
+    for (Index i=1; i<n; ++i) {
+      if (is_lms(i)) lms.push_back(i);
+    }
+    return lms;
+  };
+
+  buckets();
+  ::std::vector<Index> lms = lms_positions();
+  Index m = lms.size();
+  induce(lms);
+  ::std::vector<Index>().swap(lms);
+  if (m == 0) return sa;
+
+  // move the LMS suffixes, in their induced order, to the front of sa,
+  // and name their substrings in this order, equal ones alike,
+  // in sa[m+p/2] for the LMS position p (LMS positions are 2 apart)
+  Index k = 0;
+  for (Index i=0; i<n; ++i) {
+    if (is_lms(sa[i])) sa[k++] = sa[i];
+  }
+  ::std::fill(sa.begin()+m, sa.end(), -1);
+  // end of the LMS substring starting at the LMS position p
+  auto lms_end = [&](Index p) {
+    do ++p; while (p < n && !is_lms(p));
+    return p;
+  };
+  Index rec_upper = 0, end_l = lms_end(sa[0]);
+  sa[m+sa[0]/2] = 0;
+  for (Index i=1; i<m; ++i) {
+    Index l = sa[i-1], r = sa[i], end_r = lms_end(r), next_end = end_r;
+    bool same = end_l-l == end_r-r;
+    if (same) {
+      while (l < end_l && at(l) == at(r)) {
+        ++l;
+        ++r;
+      }
+      same = l != n && r != n && at(l) == at(r);
+    }
+    if (!same) ++rec_upper;
+    sa[m+sa[i]/2] = rec_upper;
+    end_l = next_end;
+  }
+
+  ::std::vector<Index> rec_s;
+  rec_s.reserve(m);
+  for (Index i=m; i<n; ++i) {
+    if (sa[i] >= 0) rec_s.push_back(sa[i]);
+  }
+  ::std::vector<Index>().swap(sa);
+  ::std::vector<Index>().swap(sum_l);
+  ::std::vector<Index>().swap(sum_s);
+  // distinct names sort the LMS suffixes without recursing
+  ::std::vector<Index> rec_sa;
+  if (rec_upper+1 == m) {
+    rec_sa.resize(m);
+    for (Index i=0; i<m; ++i) rec_sa[rec_s[i]] = i;
+  } else {
+    rec_sa = sais_helper<Index>(rec_s, rec_upper);
+  }
+  ::std::vector<Index>().swap(rec_s);
+
+  sa.resize(n);
+  lms = lms_positions();
+  for (Index &v : rec_sa) v = lms[v];
+  ::std::vector<Index>().swap(lms);
+  buckets();
+  induce(rec_sa);
+  return sa;
+}
+
+/**
+ * Return the suffix array of t, the starting positions of its suffixes
+ * in lexicographic order, by induced sorting (SA-IS).
+ * Index is a signed integer type large enough for the size of t,
+ * int (texts of less than 2^31 characters) or long long, and is used
+ * for all the working arrays, so that 32-bit indices halve the memory.
+ * t is read in place, and the names of the LMS substrings are kept in
+ * the free half of the result: besides the result and n bits, at most
+ * n/2 indices are used at the top level, plus the recursion on the at
+ * most n/2 LMS suffixes, whose own tables grow with its alphabet.
+ * The peak measured on random, periodic and Fibonacci texts is
+ * at most about n indices, and the bound is below 3n.
+ * Runtime complexity : O(n)
+ */
+template <typename Index = int>
+::std::vector<Index> suffix_array(const ::std::string &t) {
+  return sais_helper<Index>(t, 255);
+}
+
+/**
+ * Return the LCP array of t, given its suffix array sa:
+ * lcp[i] is the length of the longest common prefix of the suffixes
+ * sa[i-1] and sa[i], and lcp[0] is 0 (Kasai's algorithm: the LCP
+ * of the suffix i+1 with its predecessor is at least the one of i minus 1).
+ * Runtime complexity : O(n)
+ */
+template <typename Index>
+::std::vector<Index> lcp_array(const ::std::string &t, const ::std::vector<Index> &sa) {
+  Index n = sa.size();
+  ::std::vector<Index> rank(n), lcp(n);
+  for (Index i=0; i<n; ++i) rank[sa[i]] = i;
+  Index h = 0;
+  for (Index i=0; i<n; ++i) {
+    if (rank[i] == 0) {
+      h = 0;
+      continue;
+    }
+    Index j = sa[rank[i]-1];
+    while (i+h < n && j+h < n && t[i+h] == t[j+h]) ++h;
+    lcp[rank[i]] = h;
+    if (h > 0) --h;
+  }
+  return lcp;
+}
+
+/**
+ * Suffix array index of a text t of n characters, answering occurrence
+ * queries for patterns of m characters: the suffixes starting with
+ * a pattern form a range of the suffix array, found by two binary
+ * searches comparing the pattern with the suffixes.
+ * The index refers to t, which must outlive it.
+ * Runtime complexity : O(n) construction,
+ *                      O(mlogn) count, O(mlogn + occ*logocc) locate
+ */
+template <typename Index = int>
+class suffix_index {
+public:
+  explicit suffix_index(const ::std::string &t) : _t(t), _sa(suffix_array<Index>(t)) {}
+
+  /**
+   * Return the range [b,e) of the suffix array whose suffixes start with p
+   * (every suffix, for an empty p).
+   */
+  ::std::pair<::std::size_t, ::std::size_t> range(const ::std::string &p) const {
+    auto b = ::std::partition_point(_sa.begin(), _sa.end(), [&](Index i) {
+      return _t.compare(i, p.size(), p) < 0;
+    });
+    auto e = ::std::partition_point(b, _sa.end(), [&](Index i) {
+      return _t.compare(i, p.size(), p) == 0;
+    });
+    return {b-_sa.begin(), e-_sa.begin()};
+  }
+
+  /**
+   * Return the number of occurrences of p in t
+   * (an empty p occurs at every position, from 0 to n).
+   */
+  ::std::size_t count(const ::std::string &p) const {
+    auto r = range(p);
+    return r.second-r.first+p.empty();
+  }
+
+  /**
+   * Return the starting positions of the occurrences of p in t, in increasing order.
+   */
+  ::std::vector<Index> locate(const ::std::string &p) const {
+    auto r = range(p);
+    ::std::vector<Index> result(_sa.begin()+r.first, _sa.begin()+r.second);
+    ::std::sort(result.begin(), result.end());
+    if (p.empty()) result.push_back(_t.size());
+    return result;
+  }
+
+  /**
+   * Return the first occurrence of p in t, or -1 if there is none.
+   */
+  Index first(const ::std::string &p) const {
+    auto r = range(p);
+    if (p.empty()) return 0;
+    if (r.first == r.second) return -1;
+    return *::std::min_element(_sa.begin()+r.first, _sa.begin()+r.second);
+  }
+
+  const ::std::vector<Index> &sa() const {
+    return _sa;
+  }
+
+  ::std::size_t size() const {
+    return _t.size();
+  }
+
+private:
+  const ::std::string &_t;
+  ::std::vector<Index> _sa;
+};
+
+} // string
+} // algorithms
+
+#endif
@@ -1,6 +1,14 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include "array.hpp"
+#include "heavy_hitters.hpp"
+#include <array>
+#include <cctype>
+#include <list>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
 #include <vector>
 
 namespace algorithms {
@@ -41,6 +49,37 @@ TEST(array,can_reach_end_test) {
   }
 }
 
+TEST(array,jump_index_test) {
+  ::std::mt19937 gen(11);
+  for (int trial=0; trial<30; ++trial) {
+    int n = 1+gen()%60;
+    ::std::vector<int> a(n);
+    for (auto &x : a) x = gen()%4;
+    array::jump_index index(a.begin(), a.end());
+    ASSERT_EQ(array::can_reach_end(a), index.min_jumps(0, n-1));
+
+    ::std::vector<::std::pair<::std::size_t,::std::size_t>> queries;
+    ::std::vector<long long> expected;
+    for (int i=0; i<n; ++i) {
+      // breadth first search from i
+      ::std::vector<long long> d(n, -1);
+      d[i] = 0;
+      for (int p=i; p<n; ++p) {
+        if (d[p] < 0) continue;
+        for (int q=p+1; q<=::std::min(n-1, p+a[p]); ++q) if (d[q] < 0) d[q] = d[p]+1;
+      }
+      for (int j=0; j<n; ++j) {
+        ASSERT_EQ(d[j], index.min_jumps(i, j));
+        queries.emplace_back(i, j);
+        expected.push_back(d[j]);
+      }
+    }
+    ::std::vector<long long> result;
+    index.min_jumps_many(queries.begin(), queries.end(), ::std::back_inserter(result));
+    ASSERT_EQ(expected, result);
+  }
+}
+
 TEST(array,delete_dupes_test) {
   using testcase = ::std::pair<::std::vector<int>, int>;
   ::std::vector<testcase> testcases = { 
@@ -65,6 +104,84 @@ TEST(array,delete_dupes_test) {
   }
 }
 
+TEST(array,sorted_set_test) {
+  ::std::mt19937 gen(5);
+  auto random_set = [&gen](::std::size_t n, int range) {
+    ::std::vector<int> v(n);
+    for (auto &x : v) x = gen()%range;
+    ::std::sort(v.begin(), v.end());
+    return v;
+  };
+  for (auto [n, m] : ::std::vector<::std::pair<::std::size_t,::std::size_t>>{{0,0},{0,10},{10,0},{50,60},{5,1000},{1000,5},{200000,150000}}) {
+    auto a = random_set(n, 3*(n+m)+1), b = random_set(m, 3*(n+m)+1);
+    auto dedup_a = a;
+    dedup_a.erase(array::dedup(dedup_a.begin(), dedup_a.end()), dedup_a.end());
+    auto parallel_a = a;
+    parallel_a.erase(array::parallel_dedup(parallel_a.begin(), parallel_a.end(), 4), parallel_a.end());
+    a.erase(::std::unique(a.begin(), a.end()), a.end());
+    b.erase(::std::unique(b.begin(), b.end()), b.end());
+    ASSERT_EQ(a, dedup_a);
+    ASSERT_EQ(a, parallel_a);
+
+    ::std::vector<int> expected, result, parallel_result(a.size()+b.size());
+    ::std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), ::std::back_inserter(expected));
+    array::sorted_intersection(a.begin(), a.end(), b.begin(), b.end(), ::std::back_inserter(result));
+    ASSERT_EQ(expected, result);
+    auto end = array::parallel_sorted_intersection(a.begin(), a.end(), b.begin(), b.end(), parallel_result.begin(), 4);
+    ASSERT_EQ(expected, ::std::vector<int>(parallel_result.begin(), end));
+
+    expected.clear(), result.clear();
+    ::std::set_union(a.begin(), a.end(), b.begin(), b.end(), ::std::back_inserter(expected));
+    array::sorted_union(a.begin(), a.end(), b.begin(), b.end(), ::std::back_inserter(result));
+    ASSERT_EQ(expected, result);
+    end = array::parallel_sorted_union(a.begin(), a.end(), b.begin(), b.end(), parallel_result.begin(), 4);
+    ASSERT_EQ(expected, ::std::vector<int>(parallel_result.begin(), end));
+
+    expected.clear(), result.clear();
+    ::std::set_difference(a.begin(), a.end(), b.begin(), b.end(), ::std::back_inserter(expected));
+    array::sorted_difference(a.begin(), a.end(), b.begin(), b.end(), ::std::back_inserter(result));
+    ASSERT_EQ(expected, result);
+    end = array::parallel_sorted_difference(a.begin(), a.end(), b.begin(), b.end(), parallel_result.begin(), 4);
+    ASSERT_EQ(expected, ::std::vector<int>(parallel_result.begin(), end));
+  }
+
+  // runs of equal elements reaching into the next chunks, and covering one
+  ::std::vector<int> runs(4*65536);
+  for (int i=0; i<static_cast<int>(runs.size()); ++i) runs[i] = i;
+  ::std::fill(runs.begin()+65533, runs.begin()+65540, 65533);
+  ::std::fill(runs.begin()+2*65536-1, runs.begin()+3*65536+2, 2*65536-1);
+  auto parallel_runs = runs;
+  parallel_runs.erase(array::parallel_dedup(parallel_runs.begin(), parallel_runs.end(), 4), parallel_runs.end());
+  runs.erase(::std::unique(runs.begin(), runs.end()), runs.end());
+  ASSERT_EQ(runs, parallel_runs);
+
+  ::std::vector<::std::string> s{"a","a","b","c","c","c"};
+  s.erase(array::dedup(s.begin(), s.end()), s.end());
+  ASSERT_EQ(::std::vector<::std::string>({"a","b","c"}), s);
+}
+
+TEST(array,kway_merge_test) {
+  ::std::mt19937 gen(9);
+  for (::std::size_t k : {1, 2, 3, 5, 8, 13}) {
+    ::std::vector<::std::vector<::std::pair<int,::std::size_t>>> runs(k);
+    ::std::vector<::std::pair<int,::std::size_t>> expected;
+    for (::std::size_t r=0; r<k; ++r) {
+      runs[r].resize(gen()%20);
+      for (auto &x : runs[r]) x = {static_cast<int>(gen()%10), r};
+      ::std::sort(runs[r].begin(), runs[r].end());
+      expected.insert(expected.end(), runs[r].begin(), runs[r].end());
+    }
+    // equal elements come from earlier runs first
+    ::std::sort(expected.begin(), expected.end());
+    using it = ::std::vector<::std::pair<int,::std::size_t>>::iterator;
+    ::std::vector<::std::pair<it,it>> ranges;
+    for (auto &r : runs) ranges.emplace_back(r.begin(), r.end());
+    ::std::vector<::std::pair<int,::std::size_t>> merged;
+    array::kway_merge(ranges.begin(), ranges.end(), ::std::back_inserter(merged));
+    ASSERT_EQ(expected, merged);
+  }
+}
+
 TEST(array,buy_and_sell_stock_once_test) {
   using testcase = ::std::pair<::std::vector<double>, double>;
   ::std::vector<testcase> testcases = {
@@ -113,6 +230,39 @@ TEST(array,beautiful_arrangement_ii_test) {
   }
 }
 
+TEST(array,beautiful_arrangement_test) {
+  for (int n=2; n<=12; ++n) {
+    for (int k=1; k<n; ++k) {
+      array::beautiful_arrangement a(n, k);
+      auto r = array::beautiful_arrangement_ii(n, k);
+      ::std::vector<unsigned long long> v;
+      a.write(0, n, ::std::back_inserter(v));
+      ASSERT_TRUE(::std::equal(r.begin(), r.end(), v.begin(), v.end()));
+    }
+  }
+
+  // 64-bit n: the arrangement is a permutation with k distinct differences
+  unsigned long long n = 5000000000ULL, k = 4;
+  array::beautiful_arrangement big(n, k);
+  ASSERT_EQ(1ULL, big[0]);
+  ASSERT_EQ(n-k, big[n-k-1]);
+  ASSERT_EQ(n, big[n-k]);
+  ASSERT_EQ(n-k+1, big[n-k+1]);
+  ASSERT_EQ(n-1, big[n-k+2]);
+  ASSERT_EQ(n-k+2, big[n-1]);
+
+  // parallel writers
+  array::beautiful_arrangement a(300000, 1000);
+  ::std::vector<unsigned long long> expected(a.size()), buffer(a.size());
+  a.write(0, a.size(), expected.begin());
+  a.parallel_write(buffer.begin(), 4);
+  ASSERT_EQ(expected, buffer);
+  ::std::ostringstream os, expected_os;
+  a.write_text(os, ' ', 4);
+  for (auto x : expected) expected_os << x << ' ';
+  ASSERT_EQ(expected_os.str(), os.str());
+}
+
 TEST(array,generate_primes_test) {
   using testcase = ::std::tuple<int,::std::vector<int>>;
   ::std::vector<testcase> testcases = {
@@ -163,6 +313,115 @@ TEST(array,apply_permutation_test) {
   }
 }
 
+TEST(array,permutation_test) {
+  ::std::mt19937 gen(3);
+  for (::std::size_t n : {0, 1, 5, 1000, 100000}) {
+    ::std::vector<long long> p(n), q(n);
+    ::std::iota(p.begin(), p.end(), 0);
+    ::std::iota(q.begin(), q.end(), 0);
+    ::std::shuffle(p.begin(), p.end(), gen);
+    ::std::shuffle(q.begin(), q.end(), gen);
+    ::std::vector<::std::string> v(n);
+    for (::std::size_t i=0; i<n; ++i) v[i] = ::std::to_string(i);
+    ::std::vector<::std::string> r(n);
+    for (::std::size_t i=0; i<n; ++i) r[p[i]] = v[i];
+
+    auto in_place = v;
+    array::apply_permutation(p.begin(), p.end(), in_place.begin());
+    ASSERT_EQ(r, in_place);
+    ::std::vector<::std::string> out(n), parallel_out(n);
+    array::apply_permutation(p.begin(), p.end(), v.begin(), out.begin());
+    ASSERT_EQ(r, out);
+    array::parallel_apply_permutation(p.begin(), p.end(), v.begin(), parallel_out.begin(), 4);
+    ASSERT_EQ(r, parallel_out);
+
+    ::std::vector<long long> inv(n), composed(n), identity(n);
+    array::inverse_permutation(p.begin(), p.end(), inv.begin(), 4);
+    for (::std::size_t i=0; i<n; ++i) ASSERT_EQ(static_cast<long long>(i), inv[p[i]]);
+    auto inv_in_place = p;
+    array::invert_permutation(inv_in_place.begin(), inv_in_place.end());
+    ASSERT_EQ(inv, inv_in_place);
+    array::compose_permutations(p.begin(), p.end(), inv.begin(), identity.begin());
+    for (::std::size_t i=0; i<n; ++i) ASSERT_EQ(static_cast<long long>(i), identity[i]);
+
+    // applying p then q is applying their composition
+    array::compose_permutations(p.begin(), p.end(), q.begin(), composed.begin(), 4);
+    auto twice = v, once = v;
+    array::apply_permutation(p.begin(), p.end(), twice.begin());
+    array::apply_permutation(q.begin(), q.end(), twice.begin());
+    array::apply_permutation(composed.begin(), composed.end(), once.begin());
+    ASSERT_EQ(twice, once);
+  }
+}
+
+TEST(array,permutation_generator_test) {
+  for (int n=0; n<=6; ++n) {
+    ::std::vector<int> a(n);
+    ::std::iota(a.begin(), a.end(), 0);
+    auto total = array::factorial_helper(n);
+
+    // lexicographic, in batches, matches next_permutation
+    array::permutation_generator<int> lex(a.begin(), a.end());
+    ::std::vector<int> buffer(7*n), expected = a;
+    ::std::size_t count = 0;
+    while (!lex.done()) {
+      ::std::size_t m = lex.next_batch(buffer.begin(), 7);
+      for (::std::size_t k=0; k<m; ++k, ++count) {
+        ASSERT_TRUE(::std::equal(expected.begin(), expected.end(), buffer.begin()+k*n));
+        ASSERT_EQ(count, array::permutation_rank(expected.begin(), expected.end()));
+        auto u = a;
+        array::permutation_unrank(count, u.begin(), u.end());
+        ASSERT_EQ(expected, u);
+        ::std::next_permutation(expected.begin(), expected.end());
+      }
+    }
+    ASSERT_EQ(total, count);
+
+    // heap and plain changes go through all the permutations,
+    // plain changes swapping adjacent elements only
+    for (auto order : {array::permutation_order::heap, array::permutation_order::plain_changes}) {
+      array::permutation_generator<int> g(a.begin(), a.end(), order);
+      ::std::vector<::std::vector<int>> seen;
+      auto prev = g.current();
+      do {
+        auto &cur = g.current();
+        if (order == array::permutation_order::plain_changes && !seen.empty()) {
+          int diff = 0, first = -1;
+          for (int i=0; i<n; ++i) if (cur[i] != prev[i]) { ++diff; if (first < 0) first = i; }
+          ASSERT_EQ(2, diff);
+          ASSERT_EQ(cur[first], prev[first+1]);
+        }
+        seen.push_back(cur);
+        prev = cur;
+      } while (g.next());
+      ASSERT_EQ(total, seen.size());
+      ::std::sort(seen.begin(), seen.end());
+      ASSERT_TRUE(::std::adjacent_find(seen.begin(), seen.end()) == seen.end());
+    }
+
+    // shards cover the permutations in order
+    ::std::vector<int> all;
+    for (auto [b, e] : array::permutation_shards(n, 4)) {
+      array::permutation_generator<int> shard(a.begin(), a.end(), b, e);
+      ::std::vector<int> out(n*(e-b)+1);
+      ASSERT_EQ(e-b, shard.next_batch(out.begin(), 1000));
+      all.insert(all.end(), out.begin(), out.end()-1);
+    }
+    ::std::vector<int> lex_all(n*total+1);
+    array::permutation_generator<int>(a.begin(), a.end()).next_batch(lex_all.begin(), total);
+    lex_all.pop_back();
+    ASSERT_EQ(lex_all, all);
+  }
+
+  ::std::vector<int> v{1,2,2,3};
+  int count = 1;
+  while (array::next_permutation(v.begin(), v.end())) ++count;
+  ASSERT_EQ(12, count);
+  ASSERT_EQ(::std::vector<int>({3,2,2,1}), v);
+  ::std::vector<int> last{20,19,18,17,16,15,14,13,12,11,10,9,8,7,6,5,4,3,2,1};
+  ASSERT_EQ(2432902008176640000ULL-1, array::permutation_rank(last.begin(), last.end()));
+}
+
 TEST(array,next_permutation_test) {
   using testcase = ::std::pair<::std::vector<int>,::std::vector<int>>;
   ::std::vector<testcase> testcases = {
@@ -198,6 +457,160 @@ TEST(array,find_longest_subarray_test) {
   }
 }
 
+TEST(array,count_patterns_test) {
+  ::std::mt19937 gen(7);
+  for (int trial=0; trial<50; ++trial) {
+    ::std::vector<int> v(gen()%30);
+    for (auto &x : v) x = gen()%8;
+    int n = v.size();
+    long long inc2 = 0, inc3 = 0, dec3 = 0, p132 = 0, p231 = 0, p312 = 0, p213 = 0;
+    for (int i=0; i<n; ++i) {
+      for (int j=i+1; j<n; ++j) {
+        inc2 += v[i] < v[j];
+        for (int k=j+1; k<n; ++k) {
+          inc3 += v[i] < v[j] && v[j] < v[k];
+          dec3 += v[i] > v[j] && v[j] > v[k];
+          p132 += v[i] < v[k] && v[k] < v[j];
+          p231 += v[k] < v[i] && v[i] < v[j];
+          p312 += v[j] < v[k] && v[k] < v[i];
+          p213 += v[j] < v[i] && v[i] < v[k];
+        }
+      }
+    }
+    ASSERT_EQ(n, array::count_increasing_subsequences(v.begin(), v.end(), 1));
+    ASSERT_EQ(inc2, array::count_increasing_subsequences(v.begin(), v.end(), 2));
+    ASSERT_EQ(inc3, array::count_increasing_subsequences(v.begin(), v.end(), 3));
+    ASSERT_EQ(dec3, array::count_increasing_subsequences(v.begin(), v.end(), 3, ::std::greater<>()));
+    ASSERT_EQ(p132, array::count_132_patterns(v.begin(), v.end()));
+    ASSERT_EQ(p312, array::count_132_patterns(v.begin(), v.end(), ::std::greater<>()));
+    ASSERT_EQ(p231, array::count_231_patterns(v.begin(), v.end()));
+    ASSERT_EQ(p213, array::count_231_patterns(v.begin(), v.end(), ::std::greater<>()));
+
+    // the detectors find a pattern exactly when there is one, with a valid witness
+    array::increasing_subsequence_detector<int> inc(3);
+    ASSERT_EQ(inc3 > 0, inc.push(v.begin(), v.end()));
+    if (inc3) {
+      auto w = inc.witness();
+      ASSERT_TRUE(w[0] < w[1] && w[1] < w[2] && v[w[0]] < v[w[1]] && v[w[1]] < v[w[2]]);
+      ASSERT_EQ(w[2]+1, inc.size());
+    }
+    array::pattern_132_detector<int> d132;
+    ASSERT_EQ(p132 > 0, d132.push(v.begin(), v.end()));
+    if (p132) {
+      auto w = d132.witness();
+      ASSERT_TRUE(w[0] < w[1] && w[1] < w[2] && v[w[0]] < v[w[2]] && v[w[2]] < v[w[1]]);
+    }
+    array::pattern_231_detector<int> d231;
+    ASSERT_EQ(p231 > 0, d231.push(v.begin(), v.end()));
+    if (p231) {
+      auto w = d231.witness();
+      ASSERT_TRUE(w[0] < w[1] && w[1] < w[2] && v[w[2]] < v[w[0]] && v[w[0]] < v[w[1]]);
+    }
+    array::pattern_231_detector<int, ::std::greater<>> d213;
+    ASSERT_EQ(p213 > 0, d213.push(v.begin(), v.end()));
+  }
+
+  // chunks of a stream
+  array::increasing_subsequence_detector<int> inc(4);
+  ::std::vector<int> a{5,1,6}, b{2,7,3}, c{4,0,9};
+  ASSERT_FALSE(inc.push(a.begin(), a.end()));
+  ASSERT_FALSE(inc.push(b.begin(), b.end()));
+  ASSERT_TRUE(inc.push(c.begin(), c.end()));
+  ASSERT_EQ(::std::vector<long long>({1,3,5,6}), inc.witness());
+  ASSERT_EQ(7, inc.size());
+}
+
+TEST(array,balanced_subarray_index_test) {
+  ::std::string s = "a1aaa111a1aa11aaaaaa";
+  array::balanced_subarray_index<> index(s.begin(), s.end());
+  ASSERT_EQ(::std::make_pair(0LL,13LL), index.longest());
+
+  // brute force over every range, compared by length
+  auto length = [](::std::pair<long long,long long> p) { return p.second-p.first+1; };
+  ::std::vector<::std::pair<long long,long long>> queries;
+  ::std::vector<long long> expected;
+  for (long long l=0; l<static_cast<long long>(s.size()); ++l) {
+    for (long long r=l; r<static_cast<long long>(s.size()); ++r) {
+      long long best = 0;
+      for (long long i=l; i<=r; ++i) {
+        int sum = 0;
+        for (long long j=i; j<=r; ++j) {
+          sum += ::std::isdigit(s[j])?1:-1;
+          if (sum == 0) best = ::std::max(best, j-i+1);
+        }
+      }
+      queries.emplace_back(l, r);
+      expected.push_back(best);
+      auto p = index.longest(l, r);
+      ASSERT_EQ(best, length(p));
+      if (best) {
+        ASSERT_TRUE(l <= p.first && p.second <= r);
+      }
+    }
+  }
+  ::std::vector<::std::pair<long long,long long>> result;
+  index.longest_many(queries.begin(), queries.end(), ::std::back_inserter(result));
+  ASSERT_EQ(queries.size(), result.size());
+  for (::std::size_t k=0; k<queries.size(); ++k) {
+    ASSERT_EQ(expected[k], length(result[k]));
+    ASSERT_EQ(index.longest(queries[k].first, queries[k].second), result[k]);
+  }
+
+  // range tables against the scan, on every range of a longer string
+  ::std::mt19937 gen(32);
+  ::std::string t(300, 'a');
+  for (char &c : t) c = gen()%3 ? 'a' : '1';
+  for (int i=100; i<200; ++i) t[i] = i%2 ? 'a' : '1';
+  array::balanced_subarray_index<> scan(t.begin(), t.end()), tables(t.begin(), t.end());
+  tables.build_tables();
+  for (long long l=0; l<static_cast<long long>(t.size()); l+=3) {
+    for (long long r=l; r<static_cast<long long>(t.size()); ++r) {
+      ASSERT_EQ(scan.longest(l, r), tables.longest(l, r));
+    }
+  }
+  ASSERT_EQ(scan.longest(), tables.longest());
+  queries.clear();
+  for (long long l=0; l<static_cast<long long>(t.size()); l+=7) {
+    for (long long r=l; r<static_cast<long long>(t.size()); r+=5) queries.emplace_back(l, r);
+  }
+  result.clear();
+  scan.longest_many(queries.begin(), queries.end(), ::std::back_inserter(result));
+  for (::std::size_t k=0; k<queries.size(); ++k) {
+    ASSERT_EQ(scan.longest(queries[k].first, queries[k].second), result[k]);
+  }
+
+  // ranges are clamped to the array
+  ASSERT_EQ(index.longest(), index.longest(-5, 100));
+  ASSERT_EQ(::std::make_pair(0LL,-1LL), index.longest(5, 3));
+  ASSERT_EQ(::std::make_pair(0LL,-1LL), index.longest(30, 40));
+  ASSERT_EQ(::std::make_pair(0LL,-1LL), tables.longest(10, 2));
+  queries = {{-5, 100}, {5, 3}, {30, 40}};
+  result.clear();
+  index.longest_many(queries.begin(), queries.end(), ::std::back_inserter(result));
+  ASSERT_EQ(index.longest(), result[0]);
+  ASSERT_EQ(::std::make_pair(0LL,-1LL), result[1]);
+  ASSERT_EQ(::std::make_pair(0LL,-1LL), result[2]);
+
+  // pluggable classifier: balanced parentheses counts
+  ::std::string p = "(()(((";
+  auto paren = [](char c) { return c == '(' ? 1 : -1; };
+  array::balanced_subarray_index<decltype(paren)> parens(p.begin(), p.end(), paren);
+  ASSERT_EQ(::std::make_pair(1LL,2LL), parens.longest());
+  ASSERT_EQ(::std::make_pair(2LL,3LL), parens.longest(2, 5));
+}
+
+TEST(array,balanced_subarray_stream_test) {
+  ::std::string s = "a1aaa111a1aa11aaaaaa";
+  array::balanced_subarray_stream<> stream;
+  for (::std::size_t i=0; i<s.size(); ++i) {
+    stream.push(s[i]);
+    auto r = array::find_longest_subarray(s.begin(), s.begin()+i+1);
+    ASSERT_EQ(r.second-r.first, stream.longest().second-stream.longest().first);
+  }
+  ASSERT_EQ(::std::make_pair(0LL,13LL), stream.longest());
+  ASSERT_EQ(20, stream.size());
+}
+
 TEST(array,circus_tower_test) {
   using testcase = ::std::pair<::std::vector<::std::pair<int,int>>,::std::vector<::std::pair<int,int>>>;
   ::std::vector<testcase> testcases = {
@@ -224,6 +637,51 @@ TEST(array,total_fruit_test) {
   }
 }
 
+TEST(array,robin_hood_counter_test) {
+  array::robin_hood_counter<int> counter(1);
+  ::std::vector<int> count(1000, 0);
+  ::std::mt19937 gen(42);
+  ::std::uniform_int_distribution<int> dist(0, 999);
+  for (int i=0; i<20000; ++i) {
+    int x = dist(gen)*1024 % 1000;
+    if (count[x] && gen()%3 == 0) ASSERT_EQ(--count[x], counter.remove(x));
+    else ASSERT_EQ(++count[x], counter.add(x));
+  }
+  for (int x=0; x<1000; ++x) ASSERT_EQ(count[x], counter.count(x));
+  ASSERT_EQ(static_cast<::std::size_t>(::std::count_if(count.begin(), count.end(), [](int c) { return c > 0; })),
+            counter.distinct());
+}
+
+TEST(array,k_distinct_test) {
+  using testcase = ::std::tuple<::std::vector<int>,int,::std::size_t,long long>;
+  ::std::vector<testcase> testcases = {
+    {{1,2,1,2,3},2,4,7},
+    {{1,2,1,3,4},3,4,3},
+    {{1,1,1},1,3,6},
+    {{1,2,3},0,0,0},
+    {{1,2,3},4,3,0},
+    {{3,3,3,1,2,1,1,2,3,3,4},2,5,16},
+  };
+  for (auto &[v, k, longest, exactly] : testcases) {
+    ASSERT_EQ(longest, array::longest_at_most_k_distinct(v.begin(), v.end(), k));
+    ASSERT_EQ(exactly, array::count_exactly_k_distinct(v.begin(), v.end(), k));
+    ASSERT_EQ(longest, array::longest_at_most_k_distinct(v.begin(), v.end(), k, array::flat_counter(5)));
+    ASSERT_EQ(exactly, array::count_exactly_k_distinct(v.begin(), v.end(), k, array::flat_counter(5)));
+    array::k_distinct_stream<int> stream(k);
+    for (auto x : v) stream.push(x);
+    ASSERT_EQ(longest, stream.longest());
+    ASSERT_EQ(exactly, stream.exactly_k());
+  }
+
+  array::distinct_window<int> window;
+  for (int x : {1,2,1,3}) window.push(x);
+  ASSERT_EQ(3u, window.distinct());
+  window.pop();
+  window.pop();
+  ASSERT_EQ(2u, window.distinct());
+  ASSERT_EQ(1, window.front());
+}
+
 TEST(array,majority_element_test) {
   using testcase = ::std::pair<::std::vector<int>,int>;
   ::std::vector<testcase> testcases = {
@@ -243,13 +701,323 @@ TEST(array,majority_element_ii_test) {
   using testcase = ::std::pair<::std::vector<int>,::std::vector<int>>;
   ::std::vector<testcase> testcases = {
     {{3,2,3},{3}},
-    {{1,1,1,3,3,2,2,2},{2,1}}
+    {{1,1,1,3,3,2,2,2},{1,2}},
+    {{1,2,3},{}},
+    {{4,4,4,4},{4}}
   };
   for (auto &[v, r] : testcases) {
     ASSERT_THAT(array::majority_element_ii(v),::testing::Eq(r));
+    ::std::list<int> l(v.begin(), v.end());
+    ASSERT_THAT(array::majority_element_ii(l.begin(), l.end()),::testing::Eq(r));
+    ::std::vector<long long> w(v.begin(), v.end());
+    ASSERT_THAT(array::majority_element_ii(w.begin(), w.end()),::testing::Eq(::std::vector<long long>(r.begin(), r.end())));
+  }
+}
+
+
+TEST(array,range_overloads_test) {
+  ::std::array<int,7> a{3,3,1,0,2,0,1};
+  ASSERT_EQ(3, array::can_reach_end(a.begin(), a.end()));
+
+  int d[] = {1,1,2,3,3,3,4};
+  ASSERT_EQ(d+4, array::delete_dupes(::std::begin(d), ::std::end(d)));
+  ASSERT_THAT(::std::vector<int>(d,d+4), ::testing::ElementsAre(1,2,3,4));
+
+  int e[] = {5,2,7,4,1,8};
+  array::even_odd(::std::begin(e), ::std::end(e));
+  ASSERT_TRUE(::std::is_partitioned(::std::begin(e), ::std::end(e), [](int x){return x%2==0;}));
+
+  int q[] = {4,1,4,9,0,4,7};
+  array::partition(::std::begin(q), ::std::end(q), 4);
+  ::std::sort(q,q+2);
+  ASSERT_THAT(::std::vector<int>(q,q+2), ::testing::ElementsAre(0,1));
+  ASSERT_THAT(::std::vector<int>(q+2,q+5), ::testing::ElementsAre(4,4,4));
+
+  ::std::array<int,3> n{9,9,9};
+  ASSERT_EQ(1, array::increment(n.begin(), n.end()));
+  ASSERT_THAT(n, ::testing::ElementsAre(0,0,0));
+
+  int ma[] = {1,2,3}, mb[] = {4,5,6}, mr[6];
+  ASSERT_EQ(5, array::multiply(::std::begin(ma), ::std::end(ma), ::std::begin(mb), ::std::end(mb), mr));
+  ASSERT_THAT(::std::vector<int>(mr,mr+5), ::testing::ElementsAre(5,6,0,8,8));
+
+  const double s[] = {12.0,11.0,13.0,9.0,12.0,8.0,14.0,13.0,15.0};
+  ASSERT_EQ(7.0, array::buy_and_sell_stock_once(::std::begin(s), ::std::end(s)));
+  ASSERT_EQ(10.0, array::buy_and_sell_stock_twice(::std::begin(s), ::std::end(s)));
+
+  const int r[] = {4,5,6,7,0,1,2};
+  ASSERT_EQ(r+5, array::search_rotated(::std::begin(r), ::std::end(r), 1));
+  ASSERT_EQ(::std::end(r), array::search_rotated(::std::begin(r), ::std::end(r), 3));
+
+  int p[] = {2,0,1,3}, v[] = {13,12,11,10};
+  array::apply_permutation(::std::begin(p), ::std::end(p), ::std::begin(v));
+  ASSERT_THAT(v, ::testing::ElementsAre(12,11,13,10));
+  ASSERT_THAT(p, ::testing::ElementsAre(2,0,1,3));
+
+  ::std::array<int,4> np{1,0,3,2};
+  array::next_permutation(np.begin(), np.end());
+  ASSERT_THAT(np, ::testing::ElementsAre(1,2,0,3));
+
+  int b[5];
+  array::beautiful_arrangement_ii(5, 3, b);
+  ASSERT_THAT(b, ::testing::ElementsAre(1,2,5,3,4));
+
+  ::std::array<int,6> g;
+  array::generate_permutation(g.begin(), g.end());
+  ASSERT_TRUE(::std::is_permutation(g.begin(), g.end(), ::std::array<int,6>{0,1,2,3,4,5}.begin()));
+
+  const int m[] = {1,2,5,9,5,9,5,5,5};
+  ASSERT_EQ(5, array::majority_element(::std::begin(m), ::std::end(m)));
+  ASSERT_TRUE(array::increasing_triplet(::std::begin(m), ::std::end(m)));
+  ASSERT_TRUE(array::find_123_pattern(::std::begin(m), ::std::end(m)));
+  ASSERT_EQ(4, array::total_fruit(::std::begin(m)+3, ::std::end(m)-2));
+}
+
+TEST(array,partition_branchless_test) {
+  ::std::default_random_engine en(42);
+  for (int n : {0,1,2,127,128,129,1000,4099}) {
+    ::std::vector<int> v(n);
+    for (auto &x : v) x = ::std::uniform_int_distribution<int>{0,9}(en);
+    auto sorted = v;
+    ::std::sort(sorted.begin(), sorted.end());
+
+    auto w = v;
+    auto it = array::partition_branchless(w.begin(), w.end(), [](int x){return x<5;});
+    ASSERT_TRUE(::std::is_partitioned(w.begin(), w.end(), [](int x){return x<5;}));
+    ASSERT_EQ(::std::partition_point(w.begin(), w.end(), [](int x){return x<5;}), it);
+    ::std::sort(w.begin(), w.end());
+    ASSERT_THAT(w, ::testing::Eq(sorted));
+
+    // nothing is moved in a partitioned range
+    bool swapped;
+    w = v;
+    array::partition_branchless(w.begin(), w.end(), [](int x){return x<5;}, &swapped);
+    ASSERT_EQ(!::std::is_partitioned(v.begin(), v.end(), [](int x){return x<5;}), swapped);
+    auto partitioned = w;
+    array::partition_branchless(w.begin(), w.end(), [](int x){return x<5;}, &swapped);
+    ASSERT_FALSE(swapped);
+    ASSERT_EQ(partitioned, w);
+
+    w = v;
+    auto [lt, gt] = array::partition_branchless(w.begin(), w.end(), 4);
+    ASSERT_TRUE(::std::all_of(w.begin(), lt, [](int x){return x<4;}));
+    ASSERT_TRUE(::std::all_of(lt, gt, [](int x){return x==4;}));
+    ASSERT_TRUE(::std::all_of(gt, w.end(), [](int x){return x>4;}));
+
+    w = v;
+    array::even_odd(&w);
+    ASSERT_TRUE(::std::is_partitioned(w.begin(), w.end(), [](int x){return x%2==0;}));
+  }
+}
+
+TEST(array,stable_partition_test) {
+  using testcase = ::std::pair<::std::vector<int>,::std::vector<int>>;
+  ::std::vector<testcase> testcases = {
+    {{},{}},
+    {{1},{1}},
+    {{2},{2}},
+    {{1,2},{2,1}},
+    {{5,2,7,4,1,8,3,6},{2,4,8,6,5,7,1,3}}
+  };
+  for (auto &[v, r] : testcases) {
+    auto it = array::stable_partition(&v, [](int x){return x%2==0;});
+    ASSERT_THAT(v, ::testing::Eq(r));
+    ASSERT_EQ(::std::count_if(v.begin(), v.end(), [](int x){return x%2==0;}), it-v.begin());
+  }
+}
+
+TEST(array,parallel_partition_test) {
+  ::std::vector<int> v(1 << 18);
+  ::std::default_random_engine en(7);
+  for (auto &x : v) x = ::std::uniform_int_distribution<int>{0,1000}(en);
+  auto r = v;
+  auto rit = ::std::stable_partition(r.begin(), r.end(), [](int x){return x%3==0;});
+  for (unsigned t : {1u,3u,4u}) {
+    auto w = v;
+    auto it = array::parallel_partition(w.begin(), w.end(), [](int x){return x%3==0;}, t);
+    ASSERT_EQ(rit-r.begin(), it-w.begin());
+    ASSERT_THAT(w, ::testing::Eq(r));
+  }
+}
+
+TEST(array,misra_gries_test) {
+  array::misra_gries<int> mg(4);
+  ::std::vector<int> v = {1,2,1,3,1,4,2,5,1,2,6,1};
+  mg.add(v.begin(), v.end());
+  ASSERT_EQ(12, mg.size());
+  for (int x=1; x<=6; ++x) {
+    auto c = ::std::count(v.begin(), v.end(), x);
+    ASSERT_LE(mg.estimate(x), c);
+    ASSERT_GE(mg.estimate(x)+mg.error(), c);
+  }
+  ASSERT_LE(mg.error()*4, 12);
+  auto h = mg.heavy_hitters();
+  ASSERT_NE(h.end(), ::std::find(h.begin(), h.end(), 1));
+
+  // merging the summaries of two halves keeps the guarantees
+  array::misra_gries<int> left(4), right(4);
+  left.add(v.begin(), v.begin()+6);
+  right.add(v.begin()+6, v.end());
+  left.merge(right);
+  ASSERT_EQ(12, left.size());
+  ASSERT_LE(left.entries().size(), 3);
+  for (int x=1; x<=6; ++x) {
+    auto c = ::std::count(v.begin(), v.end(), x);
+    ASSERT_LE(left.estimate(x), c);
+    ASSERT_GE(left.estimate(x)+left.error(), c);
+  }
+}
+
+TEST(array,heavy_hitters_test) {
+  using testcase = ::std::tuple<::std::vector<int>,int,::std::vector<int>>;
+  ::std::vector<testcase> testcases = {
+    {{7},2,{7}},
+    {{1,2,3,4},2,{}},
+    {{1,2,3,4},5,{1,2,3,4}},
+    {{3,1,3,2,3,1,5,1},4,{1,3}},
+    {{3,1,3,2,3,1,5,1},2,{}}
+  };
+  for (auto &[v, k, r] : testcases) {
+    ASSERT_THAT(array::heavy_hitters(v.begin(), v.end(), k), ::testing::Eq(r));
+  }
+  ::std::vector<int> empty;
+  ASSERT_TRUE(array::heavy_hitters(empty.begin(), empty.end(), 2).empty());
+
+  // a large input, voted in parallel chunks
+  ::std::vector<int> v(1 << 19);
+  ::std::default_random_engine en(5);
+  for (auto &x : v) {
+    int r = ::std::uniform_int_distribution<int>{0,99}(en);
+    x = r<15 ? 42 : r<27 ? -7 : ::std::uniform_int_distribution<int>{0,1000000}(en);
+  }
+  for (unsigned t : {1u,4u}) {
+    ASSERT_THAT(array::heavy_hitters(v.begin(), v.end(), 10, t), ::testing::ElementsAre(-7,42));
+  }
+}
+
+/**
+ * Reference O(n*k) solution for buy_and_sell_stock_k.
+ */
+double buy_and_sell_stock_k_dp(const ::std::vector<double> &v, int k) {
+  ::std::vector<double> buy(k, -1e18), sell(k, 0.0);
+  for (double p : v) {
+    for (int j=0; j<k; ++j) {
+      buy[j] = ::std::max(buy[j], (j?sell[j-1]:0.0)-p);
+      sell[j] = ::std::max(sell[j], buy[j]+p);
+    }
+  }
+  return k?sell.back():0.0;
+}
+
+TEST(array,buy_and_sell_stock_k_test) {
+  using testcase = ::std::tuple<::std::vector<double>,int,double>;
+  ::std::vector<testcase> testcases = {
+    {{},3,0.0},
+    {{10.0},3,0.0},
+    {{10.0,20.0},0,0.0},
+    {{3.0,2.0,6.0,5.0,0.0,3.0},2,7.0},
+    {{12.0,11.0,13.0,9.0,12.0,8.0,14.0,13.0,15.0},1,7.0},
+    {{12.0,11.0,13.0,9.0,12.0,8.0,14.0,13.0,15.0},2,10.0},
+    {{12.0,11.0,13.0,9.0,12.0,8.0,14.0,13.0,15.0},3,12.0},
+    {{12.0,11.0,13.0,9.0,12.0,8.0,14.0,13.0,15.0},10,13.0}
+  };
+  for (auto &[v, k, r] : testcases) {
+    ASSERT_EQ(r, array::buy_and_sell_stock_k(v,k));
+  }
+
+  ::std::default_random_engine en(6);
+  for (int i=0; i<200; ++i) {
+    ::std::vector<double> v(::std::uniform_int_distribution<int>{0,40}(en));
+    for (auto &x : v) x = ::std::uniform_int_distribution<int>{0,20}(en);
+    int k = ::std::uniform_int_distribution<int>{0,12}(en);
+    ASSERT_EQ(buy_and_sell_stock_k_dp(v,k), array::buy_and_sell_stock_k(v,k));
+
+    array::online_stock_profit online(k);
+    ::std::vector<double> prefix;
+    for (double x : v) {
+      online.push(x);
+      prefix.push_back(x);
+      ASSERT_EQ(buy_and_sell_stock_k_dp(prefix,k), online.best());
+    }
+  }
+}
+
+TEST(array,sliding_stock_profit_test) {
+  ::std::default_random_engine en(8);
+  for (int w : {1,2,3,7,16}) {
+    array::sliding_stock_profit window(w);
+    ::std::vector<double> v;
+    for (int i=0; i<100; ++i) {
+      v.push_back(::std::uniform_int_distribution<int>{0,50}(en));
+      window.push(v.back());
+      auto first = v.end()-::std::min<int>(w, v.size());
+      ASSERT_EQ(::std::min<int>(w, v.size()), window.size());
+      ASSERT_EQ(array::buy_and_sell_stock_once(first, v.end()), window.best());
+    }
+  }
+  for (int w : {0,-1}) {
+    array::sliding_stock_profit window(w);
+    window.push(1.0);
+    window.push(2.0);
+    ASSERT_EQ(0, window.size());
+    ASSERT_EQ(0.0, window.best());
   }
 }
 
+TEST(array,find_rotation_test) {
+  using testcase = ::std::pair<::std::vector<int>,int>;
+  ::std::vector<testcase> testcases = {
+    {{},0},
+    {{1},0},
+    {{1,2,3},0},
+    {{3,1,2},1},
+    {{2,3,1},2},
+    {{1,1,1},0},
+    {{1,1,1,2,1},4},
+    {{2,1,1,1,1},1},
+    {{1,2,1,1,1},2},
+    {{4,5,6,7,0,1,2},4},
+    {{2,2,2,0,1,2},3}
+  };
+  for (auto &[v, r] : testcases) {
+    ASSERT_EQ(r, array::find_rotation(v.begin(), v.end())-v.begin());
+  }
+}
+
+TEST(array,rotated_index_test) {
+  ::std::default_random_engine en(9);
+  for (int n : {0,1,2,3,15,16,17,100,1000}) {
+    for (int dupes : {0,1}) {
+      ::std::vector<int> v(n);
+      for (int i=0; i<n; ++i) v[i] = dupes?i/3*2:2*i;
+      int r = n?::std::uniform_int_distribution<int>{0,n-1}(en):0;
+      ::std::rotate(v.begin(), v.begin()+r, v.end());
+
+      auto pivot = array::find_rotation(v.begin(), v.end());
+      array::rotated_index<int> index(v.begin(), v.end());
+      ::std::vector<int> queries;
+      for (int t=-1; t<=2*n; ++t) queries.push_back(t);
+      ::std::vector<::std::ptrdiff_t> found(queries.size());
+      index.find_many(queries.begin(), queries.end(), found.begin());
+
+      for (::std::size_t j=0; j<queries.size(); ++j) {
+        int t = queries[j];
+        bool present = ::std::find(v.begin(), v.end(), t) != v.end();
+        auto it = array::search_rotated(v.begin(), pivot, v.end(), t);
+        ASSERT_EQ(present, it != v.end());
+        if (present) {
+          ASSERT_EQ(t, *it);
+        }
+        auto i = index.find(t);
+        ASSERT_EQ(present, i >= 0);
+        if (present) {
+          ASSERT_EQ(t, v[i]);
+        }
+        ASSERT_EQ(i, found[j]);
+      }
+    }
+  }
+}
 
 } // tests
 } // algorithms
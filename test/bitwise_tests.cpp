@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 #include "bitwise.hpp"
+#include <algorithm>
+#include <random>
+#include <string>
 #include <vector>
 
 namespace algorithms {
@@ -13,5 +16,43 @@ TEST(bitwise,count_bits) {
   }
 }
 
+TEST(bitwise,is_palyndrome) {
+  using testcase = std::pair<bool, unsigned long long>;
+  const std::vector<testcase> testcases = {
+    {true,0},{true,7},{false,10},{true,11},{false,100},{true,101},{true,1221},
+    {false,1231},{true,12321},{false,1000021},{true,4294884924ULL},
+    {false,4294967295ULL},{true,18446744066044764481ULL},{false,18446744073709551615ULL},
+    {true,10000000000000000001ULL},{false,10000000000000000000ULL}
+  };
+  for (const auto &[output, input] : testcases) {
+    ASSERT_EQ(output, bitwise::is_palyndrome(input));
+    if (input <= 0xFFFFFFFFULL) {
+      ASSERT_EQ(output, bitwise::is_palyndrome(static_cast<unsigned>(input)));
+    }
+  }
+
+  // against the decimal strings, with palyndromes mixed in
+  std::mt19937_64 gen(47);
+  std::vector<unsigned long long> values(20000);
+  for (std::size_t i=0; i<values.size(); ++i) {
+    std::string d = std::to_string(gen() >> gen()%64);
+    if (i%2) {
+      // mirror at most 9 digits, around the last one for i%4 == 1
+      d = d.substr(0, 9);
+      d += std::string(d.rbegin()+i%4/2, d.rend());
+    }
+    values[i] = std::stoull(d);
+  }
+  std::vector<char> result(values.size());
+  bitwise::is_palyndrome_many(values.begin(), values.end(), result.begin(), 3);
+  std::size_t palyndromes = 0;
+  for (std::size_t i=0; i<values.size(); ++i) {
+    std::string d = std::to_string(values[i]);
+    ASSERT_EQ(std::equal(d.begin(), d.end(), d.rbegin()), result[i]) << values[i];
+    palyndromes += result[i];
+  }
+  ASSERT_LE(values.size()/2, palyndromes);
+}
+
 } // tests
 } // algorithms
@@ -1,33 +1,269 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include "math.hpp"
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
 
 namespace algorithms {
 namespace tests {
 
+TEST(math,min_total_distance_test) {
+  using testcase = ::std::pair<::std::vector<::std::vector<int>>,int>;
+  ::std::vector<testcase> testcases = {
+    {{{1,0,0,0,1},{0,0,0,0,0},{0,0,1,0,0}},6},
+    {{{1,1}},1},
+    {{{0,0},{0,0}},0},
+    {{{1},{0},{1},{1}},3}
+  };
+  for (auto &[grid, r] : testcases) {
+    ASSERT_EQ(r, math::min_total_distance(grid));
+    int rows = grid.size(), cols = grid[0].size(), words = (cols+63)/64;
+    ::std::vector<::std::pair<int,int>> points;
+    ::std::vector<::std::uint64_t> bits(rows*words, 0);
+    for (int i=0; i<rows; ++i) {
+      for (int j=0; j<cols; ++j) {
+        if (grid[i][j]) {
+          points.emplace_back(i, j);
+          bits[i*words+j/64] |= ::std::uint64_t(1) << (j%64);
+        }
+      }
+    }
+    ASSERT_EQ(r, math::min_total_distance(points, rows, cols));
+    ASSERT_EQ(r, math::min_total_distance(bits, rows, cols));
+  }
+
+  // weighted points, against every meeting point
+  ::std::mt19937 gen(1);
+  ::std::vector<::std::pair<int,int>> points(20);
+  ::std::vector<long long> weights(20);
+  for (int i=0; i<20; ++i) {
+    points[i] = {static_cast<int>(gen()%10), static_cast<int>(gen()%7)};
+    weights[i] = gen()%5;
+  }
+  long long best = -1;
+  for (int x=0; x<10; ++x) {
+    for (int y=0; y<7; ++y) {
+      long long d = 0;
+      for (int i=0; i<20; ++i) d += weights[i]*(::std::abs(points[i].first-x)+::std::abs(points[i].second-y));
+      if (best < 0 || d < best) best = d;
+    }
+  }
+  ASSERT_EQ(best, math::min_total_distance(points, weights, 10, 7));
+
+  // large inputs, counted on several threads
+  int rows = 1000, cols = 3000, words = (cols+63)/64;
+  ::std::vector<::std::uint64_t> bits(rows*words, 0);
+  points.clear();
+  for (int i=0; i<300000; ++i) {
+    int x = gen()%rows, y = gen()%cols;
+    if (bits[x*words+y/64] >> (y%64) & 1) continue;
+    bits[x*words+y/64] |= ::std::uint64_t(1) << (y%64);
+    points.emplace_back(x, y);
+  }
+  long long d = math::min_total_distance(points, rows, cols, 1);
+  ASSERT_EQ(d, math::min_total_distance(points, rows, cols, 4));
+  ASSERT_EQ(d, math::min_total_distance(bits, rows, cols, 4));
+  ASSERT_EQ(d, math::min_total_distance(points, ::std::vector<long long>(points.size(), 1), rows, cols, 4));
+
+  // set padding bits past the last column are ignored
+  for (int x=0; x<rows; ++x) bits[x*words+words-1] |= ~((::std::uint64_t(1) << (cols%64))-1);
+  ASSERT_EQ(d, math::min_total_distance(bits, rows, cols, 4));
+}
+
+TEST(math,isqrt_test) {
+  using testcase = ::std::pair<::std::uint64_t,::std::uint64_t>;
+  ::std::uint64_t m = 0xFFFFFFFFULL;
+  ::std::vector<testcase> testcases = {
+    {0,0},
+    {1,1},
+    {3,1},
+    {4,2},
+    {99,9},
+    {100,10},
+    {999999999999999999ULL,999999999},
+    {1000000000000000000ULL,1000000000},
+    {m*m-1,m-1},
+    {m*m,m},
+    {~::std::uint64_t(0),m}
+  };
+  for (auto &[n, r] : testcases) {
+    ASSERT_EQ(r, math::isqrt(n));
+  }
+}
+
+TEST(math,n_lockers_test) {
+  using testcase = ::std::pair<long long,long long>;
+  ::std::vector<testcase> testcases = {
+    {-1,0},
+    {0,0},
+    {1,1},
+    {3,1},
+    {100,10},
+    {2147483647,46340},
+    {9999999999LL,99999},
+    {10000000000LL,100000},
+    {4611686014132420608LL,2147483646},
+    {4611686014132420609LL,2147483647}
+  };
+  for (auto &[n, r] : testcases) {
+    ASSERT_EQ(r, math::n_lockers(n));
+  }
+}
+
+TEST(math,simulate_lockers_test) {
+  // the open lockers are exactly the perfect squares
+  for (::std::uint64_t n=0; n<300; ++n) {
+    auto bits = math::simulate_lockers(n, 1);
+    ASSERT_EQ(n/64+1, bits.size());
+    for (::std::uint64_t k=0; k<64*bits.size(); ++k) {
+      ::std::uint64_t r = math::isqrt(k);
+      ASSERT_EQ(k && k <= n && r*r == k, bits[k/64] >> k%64 & 1);
+    }
+  }
+
+  // several blocks and threads
+  ::std::uint64_t n = 20000003;
+  auto bits = math::simulate_lockers(n, 3);
+  long long open = 0;
+  for (auto w : bits) {
+    for (; w; w &= w-1) ++open;
+  }
+  ASSERT_EQ(math::n_lockers(n), open);
+  ASSERT_EQ(bits, math::simulate_lockers(n, 1));
+}
+
 TEST(math,add_without_plus_test) {
   using testcase = ::std::tuple<int,int,int>;
   ::std::vector<testcase> testcases = {
     {1,1,2},
     {7,5,12},
     {7,-5,2},
-    {-7,-5,-12}
+    {-7,-5,-12},
+    {-1,1,0},
+    {INT_MIN,-1,INT_MAX},
+    {INT_MAX,1,INT_MIN},
+    {INT_MIN,INT_MIN,0}
   };
   for (auto &[a, b, r] : testcases) {
     ASSERT_EQ(r, math::add_without_plus(a,b));
   }
+
+  // arrays, against native addition
+  ::std::mt19937_64 gen(43);
+  ::std::vector<::std::uint64_t> a(1000), b(1000), r(1000);
+  for (auto &x : a) x = gen();
+  for (auto &x : b) x = gen();
+  b[0] = ~a[0];
+  b[1] = 1-a[1];
+  ASSERT_EQ(r.end(), math::add_without_plus(a.begin(), a.end(), b.begin(), r.begin()));
+  for (::std::size_t i=0; i<a.size(); ++i) ASSERT_EQ(a[i]+b[i], r[i]);
+  ::std::vector<::std::uint32_t> a32(a.begin(), a.end()), b32(b.begin(), b.end()), r32(a.size());
+  math::add_without_plus(a32.begin(), a32.end(), b32.begin(), r32.begin());
+  for (::std::size_t i=0; i<a.size(); ++i) ASSERT_EQ(::std::uint32_t(a32[i]+b32[i]), r32[i]);
+  ::std::vector<int> ai(a32.begin(), a32.end()), bi(b32.begin(), b32.end()), ri(a.size());
+  math::add_without_plus(ai.begin(), ai.end(), bi.begin(), ri.begin());
+  for (::std::size_t i=0; i<a.size(); ++i) ASSERT_EQ(math::add_without_plus(ai[i], bi[i]), ri[i]);
+}
+
+TEST(math,add_limbs_test) {
+  using limbs = ::std::vector<::std::uint64_t>;
+  using testcase = ::std::tuple<limbs,limbs,bool,limbs,bool>;
+  ::std::uint64_t m = ~::std::uint64_t(0);
+  ::std::vector<testcase> testcases = {
+    {{}, {}, true, {}, true},
+    {{1}, {2}, false, {3}, false},
+    {{6}, {1}, true, {8}, false},
+    {{m}, {1}, false, {0}, true},
+    {{m,m,0}, {1,0,0}, false, {0,0,1}, false},
+    {{m,m,m}, {0,0,0}, true, {0,0,0}, true},
+    {{m,5}, {m,7}, true, {m,13}, false}
+  };
+  for (auto &[a, b, c, r, carry] : testcases) {
+    limbs s(a.size());
+    ASSERT_EQ(carry, math::add_limbs(a.begin(), a.end(), b.begin(), s.begin(), c));
+    ASSERT_EQ(r, s);
+  }
+
+  // 32-bit limbs, against 64-bit addition
+  ::std::mt19937_64 gen(44);
+  for (int i=0; i<1000; ++i) {
+    ::std::uint64_t x = gen() >> (i%64), y = gen() >> (i%3*20);
+    ::std::vector<::std::uint32_t> a{::std::uint32_t(x), ::std::uint32_t(x >> 32)};
+    ::std::vector<::std::uint32_t> b{::std::uint32_t(y), ::std::uint32_t(y >> 32)}, s(2);
+    bool carry = math::add_limbs(a.begin(), a.end(), b.begin(), s.begin());
+    ASSERT_EQ(x+y, s[0] | ::std::uint64_t(s[1]) << 32);
+    ASSERT_EQ(x+y < x, carry);
+  }
 }
 
 TEST(math,number_of_twos_test) {
-  using testcase = ::std::pair<int,int>;
+  using testcase = ::std::pair<int,long long>;
   ::std::vector<testcase> testcases = {
-    //TODO
+    {-5,0},
+    {0,0},
+    {1,0},
+    {2,1},
+    {12,2},
+    {22,6},
+    {25,9},
+    {100,20},
+    {222,69},
+    {1000000,600000}
   };
   for (auto &[n, r] : testcases) {
     ASSERT_EQ(r, math::number_of_twos(n));
   }
 }
 
+TEST(math,digit_counter_test) {
+  // brute force over small ranges, for every base and digit
+  for (unsigned base : {2, 3, 7, 10, 16}) {
+    for (unsigned d=0; d<base; ++d) {
+      math::digit_counter<> counter(base, d);
+      unsigned long long total = 0;
+      for (unsigned long long n=0; n<2000; ++n) {
+        unsigned long long x = n;
+        do {
+          total += (x%base == d);
+          x /= base;
+        } while (x);
+        ASSERT_EQ(total, counter.count(n));
+      }
+    }
+  }
+
+  // every digit appears 18*10^17 times in 0..10^18-1, and 0 is missing the leading ones
+  math::digit_counter<> twos(10, 2), zeros(10, 0);
+  unsigned long long e18 = 1000000000000000000ULL;
+  ASSERT_EQ(1800000000000000000ULL, twos.count(e18-1));
+  ASSERT_EQ(1800000000000000000ULL-111111111111111111ULL+1, zeros.count(e18-1));
+  ASSERT_EQ(1ULL, twos.count(e18+2, e18+2));
+  ASSERT_EQ(2ULL, twos.count(e18-8, e18+2));
+  ASSERT_EQ(e18-1, twos.max());
+  ASSERT_EQ(e18-1, zeros.max());
+
+  ::std::vector<::std::pair<unsigned long long,unsigned long long>> queries{{0,25},{13,25},{30,19},{2,2}};
+  ::std::vector<unsigned long long> result;
+  twos.count_many(queries.begin(), queries.end(), ::std::back_inserter(result));
+  ASSERT_EQ(::std::vector<unsigned long long>({9,7,0,1}), result);
+
+#if defined(__SIZEOF_INT128__)
+  // 10^30 in 128 bits: 30*10^29 occurrences of 7 in 0..10^30-1
+  using u128 = unsigned __int128;
+  u128 e30 = 1;
+  for (int i=0; i<30; ++i) e30 *= 10;
+  math::digit_counter<u128> sevens(10, 7);
+  ASSERT_TRUE(sevens.count(e30-1) == e30/10*30);
+  ASSERT_TRUE(sevens.count(e30, e30+7) == 1);
+  // the whole unsigned long long range, whose count does not fit in 64 bits
+  u128 all = ~0ULL;
+  ASSERT_TRUE(sevens.max() >= all);
+  ASSERT_TRUE(sevens.count(all) > ~0ULL);
+#endif
+}
+
 
 
 } // tests
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "sort.hpp"
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace algorithms {
+namespace tests {
+
+/**
+ * Inputs of various sizes and shapes:
+ * random, sorted, reverse sorted, few distinct keys, organ pipe.
+ */
+::std::vector<::std::vector<int>> sort_testcases() {
+  ::std::vector<::std::vector<int>> testcases = {{},{1},{2,1},{1,2,3},{3,3,3}};
+  ::std::default_random_engine en(1);
+  for (int n : {5,16,17,24,100,1000,5000}) {
+    ::std::vector<int> random(n), sorted(n), reversed(n), few(n), pipe(n);
+    for (int i=0; i<n; ++i) {
+      random[i] = ::std::uniform_int_distribution<int>{-1000000,1000000}(en);
+      sorted[i] = i;
+      reversed[i] = n-i;
+      few[i] = ::std::uniform_int_distribution<int>{0,3}(en);
+      pipe[i] = i<n/2?i:n-i;
+    }
+    testcases.insert(testcases.end(), {random, sorted, reversed, few, pipe});
+  }
+  return testcases;
+}
+
+TEST(sort,sort_network_test) {
+  ::std::default_random_engine en(2);
+  for (int n=0; n<=sort::kNetworkSize; ++n) {
+    ::std::vector<double> v(n);
+    for (auto &x : v) x = ::std::uniform_real_distribution<double>{-1.0,1.0}(en);
+    auto r = v;
+    ::std::sort(r.begin(), r.end());
+    sort::sort_network(v.begin(), v.end());
+    ASSERT_THAT(v, ::testing::Eq(r));
+  }
+
+  // infinities are kept, not replaced by the padding
+  const double inf = ::std::numeric_limits<double>::infinity();
+  ::std::vector<::std::vector<double>> infinite = {{inf,1,2}, {5,-inf,inf}, {inf,inf,-inf,0}};
+  for (auto &v : infinite) {
+    auto r = v;
+    ::std::sort(r.begin(), r.end());
+    auto w = v;
+    sort::sort_network(w.begin(), w.end());
+    ASSERT_THAT(w, ::testing::Eq(r));
+    w = v;
+    sort::pdqsort(w.begin(), w.end());
+    ASSERT_THAT(w, ::testing::Eq(r));
+  }
+}
+
+TEST(sort,pdqsort_test) {
+  for (auto &v : sort_testcases()) {
+    auto r = v;
+    ::std::sort(r.begin(), r.end());
+    auto w = v;
+    sort::pdqsort(w.begin(), w.end());
+    ASSERT_THAT(w, ::testing::Eq(r));
+    w = v;
+    sort::pdqsort(w.begin(), w.end(), ::std::greater<>());
+    ASSERT_THAT(w, ::testing::ElementsAreArray(r.rbegin(), r.rend()));
+  }
+}
+
+TEST(sort,radix_sort_test) {
+  for (auto &v : sort_testcases()) {
+    auto r = v;
+    ::std::sort(r.begin(), r.end());
+    auto w = v;
+    sort::radix_sort(w.begin(), w.end());
+    ASSERT_THAT(w, ::testing::Eq(r));
+    w = v;
+    sort::msd_radix_sort(w.begin(), w.end());
+    ASSERT_THAT(w, ::testing::Eq(r));
+  }
+
+  ::std::vector<::std::pair<int,int>> p, r;
+  ::std::default_random_engine en(3);
+  for (int i=0; i<3000; ++i) {
+    p.emplace_back(::std::uniform_int_distribution<int>{-5,5}(en), ::std::uniform_int_distribution<int>{-100000,100000}(en));
+  }
+  r = p;
+  ::std::sort(r.begin(), r.end());
+  auto w = p;
+  sort::radix_sort(w.begin(), w.end());
+  ASSERT_THAT(w, ::testing::Eq(r));
+  w = p;
+  sort::msd_radix_sort(w.begin(), w.end());
+  ASSERT_THAT(w, ::testing::Eq(r));
+
+  ::std::vector<unsigned long long> u = {~0ull, 0, 1ull << 40, 7, 1ull << 63};
+  sort::radix_sort(u.begin(), u.end());
+  ASSERT_THAT(u, ::testing::ElementsAre(0, 7, 1ull << 40, 1ull << 63, ~0ull));
+}
+
+TEST(sort,nth_element_test) {
+  for (auto &v : sort_testcases()) {
+    auto r = v;
+    ::std::sort(r.begin(), r.end());
+    for (size_t k : {size_t(0), v.size()/3, v.size()/2, v.size()-1}) {
+      if (k >= v.size()) continue;
+      auto w = v;
+      sort::nth_element(w.begin(), w.begin()+k, w.end());
+      ASSERT_EQ(r[k], w[k]);
+      ASSERT_TRUE(::std::all_of(w.begin(), w.begin()+k, [&](int x){return x<=w[k];}));
+      ASSERT_TRUE(::std::all_of(w.begin()+k, w.end(), [&](int x){return x>=w[k];}));
+    }
+  }
+}
+
+TEST(sort,parallel_sort_test) {
+  ::std::vector<int> v(1 << 19);
+  ::std::default_random_engine en(4);
+  for (auto &x : v) x = ::std::uniform_int_distribution<int>{0,1 << 20}(en);
+  auto r = v;
+  ::std::sort(r.begin(), r.end());
+  for (unsigned t : {1u,2u,4u}) {
+    auto w = v;
+    sort::parallel_sort(w.begin(), w.end(), t);
+    ASSERT_THAT(w, ::testing::Eq(r));
+  }
+}
+
+} // tests
+} // algorithms
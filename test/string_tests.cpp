@@ -1,6 +1,12 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include "string.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 namespace algorithms {
@@ -22,6 +28,28 @@ TEST(string,is_palyndrome_test) {
   for (auto &[s, r] : testcases) {
     ASSERT_EQ(r, string::is_palyndrome(s));
   }
+
+  // every length around the word and block sizes, with one mismatch anywhere
+  ::std::mt19937 gen(48);
+  ::std::vector<::std::string> strings;
+  for (::std::size_t n=0; n<100; ++n) {
+    ::std::string s(n, 'a');
+    for (::std::size_t i=0; i<(n+1)/2; ++i) s[i] = s[n-1-i] = 'a'+gen()%3;
+    ASSERT_TRUE(string::is_palyndrome(s));
+    strings.push_back(s);
+    for (::std::size_t i=0; i<n; ++i) {
+      if (2*i+1 == n) continue;
+      ::std::string t = s;
+      t[i] = 'z';
+      ASSERT_FALSE(string::is_palyndrome(t)) << t;
+      strings.push_back(t);
+    }
+  }
+  ::std::vector<char> result(strings.size());
+  string::is_palyndrome_many(strings.begin(), strings.end(), result.begin(), 3);
+  for (::std::size_t i=0; i<strings.size(); ++i) {
+    ASSERT_EQ(::std::equal(strings[i].begin(), strings[i].end(), strings[i].rbegin()), result[i]);
+  }
 }
 
 TEST(string,string_to_int_test) {
@@ -64,12 +92,40 @@ TEST(string,reverse_words_test) {
   ::std::vector<testcase> testcases = {
     {"",""},
     {"alice likes bob","bob likes alice"},
-    {"ciao","ciao"}
+    {"ciao","ciao"},
+    {" a  bb\tccc\n","\nccc\tbb  a "},
+    {"\r\n\v\f","\r\n\v\f"},
+    {"x\x80\xa0y z","z x\x80\xa0y"},
+    {"the quick brown fox jumps over the lazy dog","dog lazy the over jumps fox brown quick the"}
   };
   for (auto &[s,r]: testcases) {
     ASSERT_NO_THROW(string::reverse_words(&s));
     ASSERT_EQ(r,s);
   }
+
+  // against splitting into runs, over large buffers and several threads
+  ::std::mt19937 gen(48);
+  const char alphabet[] = "ab \t\n";
+  for (::std::size_t n : {0, 1, 17, 1000, 300000}) {
+    for (int spaces : {1, 4, 40}) {
+      ::std::string s(n, 'a');
+      for (auto &c : s) c = gen()%spaces ? alphabet[gen()%2] : alphabet[2+gen()%3];
+      ::std::vector<::std::string> runs;
+      for (::std::size_t i=0; i<n; ) {
+        ::std::size_t j = i+1;
+        while (j<n && !::std::isspace(s[j]) == !::std::isspace(s[i])) ++j;
+        runs.push_back(s.substr(i, j-i));
+        i = j;
+      }
+      ::std::string r;
+      for (auto it=runs.rbegin(); it!=runs.rend(); ++it) r += *it;
+      for (unsigned t : {1u, 3u}) {
+        ::std::string w = s;
+        string::reverse_words(&w[0], &w[0]+w.size(), t);
+        ASSERT_EQ(r, w);
+      }
+    }
+  }
 }
 
 TEST(string,count_substrings_test) {
@@ -96,10 +152,81 @@ TEST(string,find_lus_length_test) {
   ::std::vector<testcase> testcases = {
     {{"aba","cdc","eae"},3},
     {{"aba","aba","aba"},-1},
-    {{"aba","aa","bc"},3}
+    {{"aba","aa","bc"},3},
+    {{},-1},
+    {{""},0},
+    {{"",""},-1},
+    {{"aabbcc","aabbcc","cb"},2},
+    {{"aabbcc","aabbcc","abc"},-1},
+    {{"abcd","abcd","abc","ab","xy","xy"},-1},
+    {{"abcd","abcd","abc","ab","xy","yx"},2}
   };
   for (auto &[v, r] : testcases) {
     ASSERT_EQ(r, string::find_lus_length(v));
+    ASSERT_EQ(r, string::find_lus_length(v, 3));
+  }
+
+  // against the definition, over small alphabets
+  ::std::mt19937 gen(46);
+  for (int k=0; k<200; ++k) {
+    ::std::vector<::std::string> v(1+gen()%8);
+    for (auto &x : v) {
+      x.resize(gen()%6);
+      for (auto &c : x) c = 'a'+gen()%2;
+    }
+    int longest = -1;
+    for (::std::size_t i=0; i<v.size(); ++i) {
+      bool found = false;
+      for (::std::size_t j=0; j<v.size(); ++j) {
+        if (i != j && string::is_subsequence(v[i], v[j])) found = true;
+      }
+      if (!found) longest = ::std::max<int>(longest, v[i].size());
+    }
+    ASSERT_EQ(longest, string::find_lus_length(v, 1+k%3));
+  }
+}
+
+TEST(string,is_subsequence_test) {
+  using testcase = ::std::tuple<::std::string, ::std::string, bool>;
+  ::std::vector<testcase> testcases = {
+    {"","",true},
+    {"","abc",true},
+    {"abc","",false},
+    {"ace","abcde",true},
+    {"aec","abcde",false},
+    {"abcde","abcde",true},
+    {"aa","ab",false},
+    {"\xff\x01","a\xff" "b\x01",true}
+  };
+  for (auto &[s1, s2, r] : testcases) {
+    ASSERT_EQ(r, string::is_subsequence(s1, s2));
+    string::subsequence_index index(s2);
+    ASSERT_EQ(r, index.contains(s1));
+  }
+
+  ::std::mt19937 gen(47);
+  ::std::string text(5000, 'a');
+  for (auto &c : text) c = 'a'+gen()%4;
+  string::subsequence_index index(text);
+  ::std::vector<::std::string> queries(1000);
+  for (::std::size_t k=0; k<queries.size(); ++k) {
+    queries[k].resize(k < 900 ? gen()%50 : 2000+gen()%3500);
+    for (auto &c : queries[k]) c = 'a'+gen()%4;
+    if (k%2) {
+      // a subsequence of the text
+      ::std::size_t j = 0;
+      for (auto &c : queries[k]) {
+        while (j < text.size() && text[j] == 'd') ++j;
+        c = j < text.size() ? text[j] : 'a';
+        j += 1+gen()%2;
+      }
+    }
+  }
+  ::std::vector<char> result(queries.size());
+  index.contains_many(queries.begin(), queries.end(), result.begin(), 3);
+  for (::std::size_t k=0; k<queries.size(); ++k) {
+    ASSERT_EQ(string::is_subsequence(queries[k], text), result[k]);
+    ASSERT_EQ(string::is_subsequence(queries[k], text), index.contains(queries[k]));
   }
 }
 
@@ -113,11 +240,93 @@ TEST(string,look_and_say_test) {
     {5,"111221"},
     {6,"312211"},
     {7,"13112221"},
-    {8,"1113213211"}
+    {8,"1113213211"},
+    {9,"31131211131221"}
   };
   for (auto &[i, r] : testcases) {
     ASSERT_EQ(r, string::look_and_say(i));
   }
+  ::std::string term = "1";
+  for (int n=2; n<=40; ++n) {
+    ::std::string next;
+    for (::std::size_t j=0; j<term.size();) {
+      ::std::size_t k = j;
+      while (k<term.size() && term[k]==term[j]) ++k;
+      next.append(::std::to_string(k-j)).push_back(term[j]);
+      j = k;
+    }
+    term = next;
+    ASSERT_EQ(term, string::look_and_say(n));
+  }
+}
+
+TEST(string,look_and_say_term_test) {
+  using testcase = ::std::pair<int, unsigned long long>;
+  ::std::vector<testcase> testcases = {
+    {1,1},
+    {7,8},
+    {8,10},
+    {50,894810},
+    {55,3369156},
+    {70,179691598},
+    {100,511247092564},
+    {string::kMaxLookAndSay,15578352330725973270ULL}
+  };
+  for (auto &[n, l] : testcases) {
+    string::look_and_say_term term(n);
+    ASSERT_EQ(l, term.size());
+    auto composition = term.composition();
+    unsigned long long total = 0;
+    for (int e=0; e<string::kConwayElementCount; ++e) {
+      total += composition[e]*::std::strlen(string::kConwayElements[e].digits);
+    }
+    if (n >= string::kConwayStart) {
+      ASSERT_EQ(l, total);
+    }
+  }
+
+  // the elements decay into their next terms
+  for (auto &e : string::kConwayElements) {
+    ::std::string decay;
+    for (int k=0; k<e.decay_size; ++k) decay += string::kConwayElements[e.decay[k]].digits;
+    ::std::string digits = e.digits, next;
+    for (::std::size_t j=0; j<digits.size();) {
+      ::std::size_t k = j;
+      while (k<digits.size() && digits[k]==digits[j]) ++k;
+      next.append(::std::to_string(k-j)).push_back(digits[j]);
+      j = k;
+    }
+    ASSERT_EQ(next, decay);
+  }
+
+  // positions, substrings and streams
+  for (int n : {3, 8, 9, 30}) {
+    ::std::string full = string::look_and_say(n);
+    string::look_and_say_term term(n);
+    for (::std::size_t i=0; i<full.size(); ++i) ASSERT_EQ(full[i], term[i]);
+    for (::std::size_t pos : {::std::size_t(0), full.size()/3, full.size()-1, full.size()}) {
+      ::std::string part;
+      term.write(pos, 100, ::std::back_inserter(part));
+      ASSERT_EQ(full.substr(pos, 100), part);
+    }
+    ::std::string streamed;
+    int calls = 0;
+    term.stream([&](const char *p, ::std::size_t l) {
+      ASSERT_GE(7u, l);
+      streamed.append(p, l);
+      ++calls;
+    }, 7);
+    ASSERT_EQ(full, streamed);
+    ASSERT_EQ((full.size()+6)/7, calls);
+  }
+  string::look_and_say_term large(string::kMaxLookAndSay);
+  ::std::string tail;
+  large.write(large.size()-5, 10, ::std::back_inserter(tail));
+  ASSERT_EQ(5, tail.size());
+  // the last digit is always the first term's
+  ASSERT_EQ('1', tail.back());
+  ASSERT_THROW(string::look_and_say_term(string::kMaxLookAndSay+1), ::std::runtime_error);
+  ASSERT_THROW(string::look_and_say(string::kMaxLookAndSay+1), ::std::runtime_error);
 }
 
 TEST(string,roman_to_integer_test) {
@@ -125,13 +334,79 @@ TEST(string,roman_to_integer_test) {
   ::std::vector<testcase> testcases = {
     {"XXXXXIIIIIIIII",59},
     {"LVIIII",59},
-    {"LIX",59}
+    {"LIX",59},
+    {"XCIX",99},
+    {"CMXCIX",999},
+    {"MMMDCCCLXXXVIII",3888},
+    {"MCMXCIV",1994},
+    {"XIX",19},
+    {"",-1},
+    {"IXC",-1},
+    {"CDM",-1},
+    {"IXI",-1},
+    {"XCX",-1},
+    {"IIV",-1},
+    {"VX",-1},
+    {"IL",-1},
+    {"XD",-1},
+    {"VIV",-1},
+    {"LXL",-1},
+    {"DCD",-1},
+    {"VIX",-1},
+    {"XVIV",-1},
+    {"IIII",4},
+    {"VV",10},
+    {"XCIV",94},
+    {"MCDXLIV",1444},
+    {"LIXa",-1},
+    {"lix",-1},
+    {::std::string("L\0I", 3),-1},
+    {::std::string(2147484,'M'),-1}
   };
   for (auto &[i, r] : testcases) {
     ASSERT_EQ(r, string::roman_to_integer(i));
   }
 }
 
+TEST(string,integer_to_roman_test) {
+  using testcase = ::std::pair<int, ::std::string>;
+  ::std::vector<testcase> testcases = {
+    {0,""},
+    {-5,""},
+    {4000,""},
+    {1,"I"},
+    {4,"IV"},
+    {59,"LIX"},
+    {1994,"MCMXCIV"},
+    {3888,"MMMDCCCLXXXVIII"},
+    {3999,"MMMCMXCIX"}
+  };
+  for (auto &[n, r] : testcases) {
+    ASSERT_EQ(r, string::integer_to_roman(n));
+  }
+  for (int n=1; n<4000; ++n) {
+    ::std::string s = string::integer_to_roman(n);
+    ASSERT_GE(string::kMaxRomanLength, s.size());
+    ASSERT_EQ(n, string::roman_to_integer(s));
+  }
+}
+
+TEST(string,roman_lines_test) {
+  ::std::vector<int> values{1, 3999, 0, 1994, 4000, 7};
+  ::std::string text(values.size()*(string::kMaxRomanLength+1), '\0');
+  char *end = string::format_roman_lines(values.begin(), values.end(), &text[0]);
+  text.resize(end-text.data());
+  ASSERT_EQ("I\nMMMCMXCIX\n\nMCMXCIV\n\nVII\n", text);
+
+  ::std::vector<int> parsed;
+  string::parse_roman_lines(text.data(), text.data()+text.size(), ::std::back_inserter(parsed));
+  ASSERT_EQ(::std::vector<int>({1, 3999, -1, 1994, -1, 7}), parsed);
+  parsed.clear();
+  ::std::string unterminated = "XIV\nIXI\nIIII\nX X\n\nMDCLXVI";
+  string::parse_roman_lines(unterminated.data(), unterminated.data()+unterminated.size(), ::std::back_inserter(parsed));
+  ASSERT_EQ(::std::vector<int>({14, -1, 4, -1, -1, 1666}), parsed);
+}
+
 TEST(string,search_test) {
   using testcase = ::std::tuple<::std::string, ::std::string, int>;
   ::std::vector<testcase> testcases = {
@@ -140,6 +415,215 @@ TEST(string,search_test) {
   };
   for (auto &[s1, s2, r] : testcases) {
     ASSERT_EQ(r, string::search(s1,s2));
+    string::suffix_index<> sa(s1);
+    ASSERT_EQ(r, string::search(sa,s2));
+    string::fm_index<> fm(s1, 2);
+    ASSERT_EQ(r, string::search(fm,s2));
+  }
+
+  // patterns longer than 8 characters overflowed a 64-bit hash of base 256
+  ::std::mt19937 gen(50);
+  for (int q=0; q<200; ++q) {
+    ::std::string t(gen()%100, 'a'), s(gen()%20, 'a');
+    for (char &c : t) c = static_cast<char>(q%2 ? gen()%256 : 'a'+gen()%2);
+    for (char &c : s) c = static_cast<char>(q%2 ? gen()%256 : 'a'+gen()%2);
+    if (q%4 == 1 && s.size() <= t.size()) s = t.substr(gen()%(t.size()-s.size()+1), s.size());
+    ASSERT_EQ(static_cast<int>(t.find(s)), string::search(t,s));
+  }
+  ::std::string t(20000, 'a');
+  for (char &c : t) c = 'a'+gen()%2;
+  for (int q=0; q<200; ++q) {
+    ::std::string s = t.substr(gen()%(t.size()-30), 1+gen()%30);
+    if (q%3 == 0) s.back() = 'c';
+    ASSERT_EQ(static_cast<int>(t.find(s)), string::search(t,s));
+  }
+  for (::std::size_t m : {1, 12, 60}) {
+    ::std::string s = t.substr(t.size()-m);
+    ASSERT_EQ(static_cast<int>(t.find(s)), string::search(t,s));
+  }
+}
+
+TEST(string,search_many_test) {
+  ::std::mt19937 gen(51);
+  ::std::string t(5000, 'a');
+  for (char &c : t) c = 'a'+gen()%3;
+  ::std::vector<::std::string> patterns = {"", "abc", "abc", "ccccccccccccccccccccccc", t, t+"a"};
+  for (int q=0; q<300; ++q) {
+    ::std::string p(1+gen()%12, 'a');
+    for (char &c : p) c = 'a'+gen()%3;
+    patterns.push_back(p);
+  }
+  auto result = string::search_many(t, patterns);
+  ASSERT_EQ(patterns.size(), result.size());
+  for (::std::size_t i=0; i<patterns.size(); ++i) {
+    ASSERT_EQ(static_cast<int>(t.find(patterns[i])), result[i]);
+  }
+  ASSERT_EQ(::std::vector<int>{-1}, string::search_many("", {"a"}));
+}
+
+TEST(string,rolling_hash_test) {
+  ASSERT_EQ(1ULL, string::mul_mod_helper(string::kMersenne61-1, string::kMersenne61-1));
+  ASSERT_EQ(1ULL, string::mul_mod_helper(1ULL << 60, 2));
+  ASSERT_EQ(2ULL, string::mul_mod_helper(1ULL << 31, 1ULL << 31));
+
+  ::std::mt19937 gen(52);
+  ::std::string t(300, 'a');
+  for (char &c : t) c = 'a'+gen()%2;
+  string::rolling_hash<> h1;
+  string::rolling_hash<2> h2;
+  string::prefix_hash<> p1(t, h1);
+  string::prefix_hash<2> p2(t, h2);
+  ASSERT_EQ(t.size(), p1.size());
+  for (int q=0; q<2000; ++q) {
+    ::std::size_t m = gen()%20, p = gen()%(t.size()-m+1), r = gen()%(t.size()-m+1);
+    ASSERT_EQ(h1.hash(t.substr(p, m)), p1.substr(p, m));
+    ASSERT_EQ(h2.hash(t.substr(p, m)), p2.substr(p, m));
+    bool equal = !t.compare(p, m, t, r, m);
+    ASSERT_EQ(equal, p1.equal(p, r, m));
+    ASSERT_EQ(equal, p2.equal(p, r, m));
+  }
+
+  // rolling the window of m characters gives the hash of the next window
+  for (::std::size_t m : {1, 7, 40}) {
+    auto h = h2.hash(t.data(), t.data()+m), power = h2.power(m);
+    for (::std::size_t j=0; j+m<t.size(); ++j) {
+      h = h2.roll(h, t[j], t[j+m], power);
+      ASSERT_EQ(p2.substr(j+1, m), h);
+    }
+  }
+
+  // bytes are hashed as unsigned values
+  string::rolling_hash<> fixed(string::rolling_hash<>::value_type{257});
+  ASSERT_EQ(256ULL, fixed.hash("\xff")[0]);
+  ASSERT_EQ(2*257+256ULL, fixed.hash(::std::string("\x01\xff"))[0]);
+}
+
+TEST(string,longest_common_substring_test) {
+  using testcase = ::std::tuple<::std::string, ::std::string, ::std::string>;
+  ::std::vector<testcase> testcases = {
+    {"", "", ""},
+    {"abc", "", ""},
+    {"abc", "def", ""},
+    {"abc", "cba", "a"},
+    {"xabcdy", "zzabcdzz", "abcd"},
+    {"GeeksforGeeks", "GeeksQuiz", "Geeks"},
+    {"aaaa", "aa", "aa"}
+  };
+  for (auto &[a, b, r] : testcases) {
+    ASSERT_EQ(r, string::longest_common_substring(a, b));
+  }
+
+  ::std::mt19937 gen(53);
+  for (int q=0; q<100; ++q) {
+    ::std::string a(gen()%40, 'a'), b(gen()%40, 'a');
+    for (char &c : a) c = 'a'+gen()%3;
+    for (char &c : b) c = 'a'+gen()%3;
+    ::std::size_t best = 0;
+    for (::std::size_t i=0; i<a.size(); ++i) {
+      for (::std::size_t j=0; j<b.size(); ++j) {
+        ::std::size_t k = 0;
+        while (i+k < a.size() && j+k < b.size() && a[i+k] == b[j+k]) ++k;
+        best = ::std::max(best, k);
+      }
+    }
+    auto r = string::longest_common_substring(a, b);
+    ASSERT_EQ(best, r.size());
+    ASSERT_NE(::std::string::npos, a.find(r));
+    ASSERT_NE(::std::string::npos, b.find(r));
+  }
+}
+
+TEST(string,suffix_array_test) {
+  ::std::mt19937 gen(49);
+  for (int n : {0, 1, 2, 3, 5, 17, 100, 1000}) {
+    // random texts, and periodic and Fibonacci ones (sigma 0), which recurse deeper
+    for (int sigma : {0, 1, 2, 4, 256}) {
+      ::std::string t(n, '\0');
+      if (sigma == 0) {
+        ::std::string fib = "ab", prev = "a";
+        while (fib.size() < t.size()) {
+          ::std::string next = fib+prev;
+          prev = fib;
+          fib = next;
+        }
+        for (int i=0; i<n; ++i) t[i] = i < n/2 ? "abaab"[i%5] : fib[i];
+      } else {
+        for (char &c : t) c = static_cast<char>(sigma == 256 ? gen()%256 : 'a'+gen()%sigma);
+      }
+      ::std::vector<int> expected(n);
+      for (int i=0; i<n; ++i) expected[i] = i;
+      ::std::sort(expected.begin(), expected.end(), [&](int i, int j) {
+        return t.compare(i, ::std::string::npos, t, j, ::std::string::npos) < 0;
+      });
+      auto sa = string::suffix_array(t);
+      ASSERT_EQ(expected, sa);
+      auto sa64 = string::suffix_array<long long>(t);
+      ASSERT_EQ(::std::vector<long long>(expected.begin(), expected.end()), sa64);
+
+      auto lcp = string::lcp_array(t, sa);
+      for (int i=1; i<n; ++i) {
+        int h = 0;
+        while (sa[i-1]+h < n && sa[i]+h < n && t[sa[i-1]+h] == t[sa[i]+h]) ++h;
+        ASSERT_EQ(h, lcp[i]);
+      }
+    }
+  }
+}
+
+TEST(string,suffix_index_test) {
+  ::std::mt19937 gen(7);
+  for (int n : {0, 1, 10, 300, 2000}) {
+    for (int sigma : {1, 2, 3, 256}) {
+      ::std::string t(n, '\0');
+      for (char &c : t) c = static_cast<char>(sigma == 256 ? gen()%256 : 'a'+gen()%sigma);
+      string::suffix_index<> sa(t);
+      string::suffix_index<long long> sa64(t);
+      string::fm_index<> fm(t, 5);
+      string::fm_index<long long> fm64(t);
+      for (int q=0; q<50; ++q) {
+        ::std::string p;
+        if (n && q%2) {
+          int b = gen()%n;
+          p = t.substr(b, gen()%8);
+        } else {
+          for (int k=gen()%4; k>0; --k) p += static_cast<char>(sigma == 256 ? gen()%256 : 'a'+gen()%sigma);
+        }
+        ::std::vector<int> expected;
+        for (int i=0; i+static_cast<int>(p.size())<=n; ++i) {
+          if (!t.compare(i, p.size(), p)) expected.push_back(i);
+        }
+        ASSERT_EQ(expected.size(), sa.count(p));
+        ASSERT_EQ(expected, sa.locate(p));
+        ASSERT_EQ(expected.size(), sa64.count(p));
+        ASSERT_EQ(expected.size(), fm.count(p));
+        ASSERT_EQ(expected, fm.locate(p));
+        ASSERT_EQ(::std::vector<long long>(expected.begin(), expected.end()), fm64.locate(p));
+        ASSERT_EQ(expected.empty() ? -1 : expected[0], fm.first(p));
+      }
+    }
+  }
+}
+
+TEST(string,rank_bitvector_test) {
+  ::std::mt19937 gen(3);
+  for (int n : {0, 1, 63, 64, 65, 511, 512, 513, 5000}) {
+    string::rank_bitvector bv(n);
+    ::std::vector<bool> bits(n);
+    for (int i=0; i<n; ++i) {
+      bits[i] = gen()%3 == 0;
+      if (bits[i]) bv.set(i);
+    }
+    bv.build();
+    ::std::size_t ones = 0;
+    for (int i=0; i<=n; ++i) {
+      ASSERT_EQ(ones, bv.rank1(i));
+      ASSERT_EQ(i-ones, bv.rank0(i));
+      if (i < n && bits[i]) {
+        ASSERT_TRUE(bv[i]);
+        ASSERT_EQ(static_cast<::std::size_t>(i), bv.select1(ones++));
+      }
+    }
+    ASSERT_EQ(ones, bv.ones());
   }
 }
 
@@ -159,7 +643,29 @@ TEST(string,word_distance_test) {
   for (auto &[t, w1, w2, r] : testcases) {
     string::word_distance wd(t);
     ASSERT_EQ(r, wd.distance(w1,w2));
+    string::suffix_index<> index(t);
+    string::word_distance indexed(t, index);
+    ASSERT_EQ(r, indexed.distance(w1,w2));
+  }
+
+  ::std::mt19937 gen(11);
+  const char *words[] = {"a", "ab", "b", "ba", "aab"};
+  const char *spaces[] = {" ", "  ", "\t", "\n "};
+  ::std::string t = " ";
+  for (int i=0; i<500; ++i) {
+    t += words[gen()%5];
+    t += spaces[gen()%4];
+  }
+  string::word_distance wd(t);
+  string::suffix_index<> index(t);
+  string::word_distance indexed(t, index);
+  for (auto w1 : words) {
+    for (auto w2 : words) {
+      ASSERT_EQ(wd.distance(w1,w2), indexed.distance(w1,w2));
+    }
   }
+  ASSERT_EQ(-1, indexed.distance("a","c"));
+  ASSERT_EQ(-1, indexed.distance("a b","a"));
 }
 
 